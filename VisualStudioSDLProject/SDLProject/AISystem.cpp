@@ -0,0 +1,214 @@
+#include "AISystem.h"
+#include <assert.h>
+
+/**
+ Default behaviours, one per AIType. Scenes can swap any of these out with register_behaviour.
+ */
+static void walker_behaviour(Entity *agent, Entity *)       { agent->ai_walker();        }
+static void guard_behaviour(Entity *agent, Entity *player)  { agent->ai_guard(player);   }
+static void striga_behaviour(Entity *agent, Entity *player) { agent->ai_striga(player);  }
+
+AISystem::AISystem()
+{
+    this->behaviours[WALKER] = walker_behaviour;
+    this->behaviours[GUARD]  = guard_behaviour;
+    this->behaviours[STRIGA] = striga_behaviour;
+}
+
+void AISystem::register_behaviour(AIType type, AIBehaviour behaviour)
+{
+    assert(type >= 0 && type < AI_TYPE_COUNT);
+    this->behaviours[type] = behaviour;
+}
+
+void AISystem::build(Map *map)
+{
+    this->left_bound = map->get_left_bound();
+    this->top_bound  = map->get_top_bound();
+
+    this->grid_width  = (int) ceil((map->get_right_bound() - map->get_left_bound()) / AI_CELL_SIZE);
+    this->grid_height = (int) ceil((map->get_top_bound() - map->get_bottom_bound()) / AI_CELL_SIZE);
+    if (this->grid_width  < 1) this->grid_width  = 1;
+    if (this->grid_height < 1) this->grid_height = 1;
+
+    this->cells.assign(this->grid_width * this->grid_height, std::vector<int>());
+}
+
+void AISystem::add(Entity *agent)
+{
+    AIAgent new_agent;
+    new_agent.entity = agent;
+    new_agent.level  = AI_ASLEEP;
+    new_agent.cell   = this->cell_of(agent->get_position());
+    new_agent.slot   = (int) this->agents.size() % AI_FAR_INTERVAL;
+    new_agent.last_position = glm::vec3(NAN); // never equal, so it's watched for at least one step
+
+    // Everyone starts asleep, standing still like an agent put to sleep in prepare(); the first update
+    // wakes whoever is already near the player
+    agent->ai_scheduled = true;
+    agent->is_sleeping  = true;
+    agent->movement     = glm::vec3(0.0f);
+    agent->model_matrix = glm::translate(glm::mat4(1.0f), agent->get_position());
+
+    this->cells[new_agent.cell].push_back((int) this->agents.size());
+    this->settling.push_back((int) this->agents.size());
+    this->agents.push_back(new_agent);
+}
+
+void AISystem::clear()
+{
+    this->agents.clear();
+    this->awake.clear();
+    this->settling.clear();
+    for (size_t i = 0; i < this->cells.size(); i++) this->cells[i].clear();
+    this->step_count = 0;
+}
+
+int const AISystem::cell_of(glm::vec3 position) const
+{
+    int cell_x = (int) floor((position.x - this->left_bound) / AI_CELL_SIZE);
+    int cell_y = (int) floor((this->top_bound - position.y) / AI_CELL_SIZE);
+
+    // Anything that has wandered off the map is kept in the nearest edge cell
+    if (cell_x < 0) cell_x = 0;
+    if (cell_y < 0) cell_y = 0;
+    if (cell_x >= this->grid_width)  cell_x = this->grid_width - 1;
+    if (cell_y >= this->grid_height) cell_y = this->grid_height - 1;
+
+    return cell_y * this->grid_width + cell_x;
+}
+
+void AISystem::move_to_cell(int agent_index, int new_cell)
+{
+    AIAgent &agent = this->agents[agent_index];
+    if (agent.cell == new_cell) return;
+
+    std::vector<int> &old_bucket = this->cells[agent.cell];
+    for (size_t i = 0; i < old_bucket.size(); i++)
+    {
+        if (old_bucket[i] == agent_index)
+        {
+            old_bucket[i] = old_bucket.back();
+            old_bucket.pop_back();
+            break;
+        }
+    }
+
+    this->cells[new_cell].push_back(agent_index);
+    agent.cell = new_cell;
+}
+
+void AISystem::wake_near(glm::vec3 position)
+{
+    // Only the cells overlapping the wake radius are visited, so sleeping agents elsewhere cost nothing
+    int first_cell = this->cell_of(glm::vec3(position.x - AI_WAKE_RADIUS, position.y + AI_WAKE_RADIUS, 0.0f));
+    int last_cell  = this->cell_of(glm::vec3(position.x + AI_WAKE_RADIUS, position.y - AI_WAKE_RADIUS, 0.0f));
+
+    int min_x = first_cell % this->grid_width, min_y = first_cell / this->grid_width;
+    int max_x = last_cell  % this->grid_width, max_y = last_cell  / this->grid_width;
+
+    for (int y = min_y; y <= max_y; y++)
+    {
+        for (int x = min_x; x <= max_x; x++)
+        {
+            std::vector<int> &bucket = this->cells[y * this->grid_width + x];
+
+            for (size_t i = 0; i < bucket.size(); i++)
+            {
+                AIAgent &agent = this->agents[bucket[i]];
+                if (agent.level != AI_ASLEEP || !agent.entity->get_active_state()) continue;
+
+                glm::vec3 offset = agent.entity->get_position() - position;
+                if (offset.x * offset.x + offset.y * offset.y > AI_WAKE_RADIUS * AI_WAKE_RADIUS) continue;
+
+                agent.level = AI_FAR;
+                agent.entity->is_sleeping = false;
+                this->awake.push_back(bucket[i]);
+            }
+        }
+    }
+}
+
+void AISystem::settle()
+{
+    // Sleep only stops an agent thinking; it still falls. Until it comes to rest its cell has to follow
+    // it, or wake_near would look for it where it fell asleep
+    for (size_t i = 0; i < this->settling.size();)
+    {
+        AIAgent &agent = this->agents[this->settling[i]];
+        glm::vec3 position = agent.entity->get_position();
+
+        if (agent.level != AI_ASLEEP || !agent.entity->get_active_state() || position == agent.last_position)
+        {
+            this->settling[i] = this->settling.back();
+            this->settling.pop_back();
+            continue;
+        }
+
+        agent.last_position = position;
+        this->move_to_cell(this->settling[i], this->cell_of(position));
+        i++;
+    }
+}
+
+void AISystem::update(Entity *player)
+{
+    this->prepare(player);
+    this->think(player, 0, this->get_thinking_count());
+}
+
+void AISystem::prepare(Entity *player)
+{
+    this->step_count++;
+    this->thinking.clear();
+
+    glm::vec3 player_position = player->get_position();
+    this->settle();
+    this->wake_near(player_position);
+
+    for (size_t i = 0; i < this->awake.size();)
+    {
+        AIAgent &agent = this->agents[this->awake[i]];
+        Entity *entity = agent.entity;
+
+        glm::vec3 offset = entity->get_position() - player_position;
+        float distance_squared = offset.x * offset.x + offset.y * offset.y;
+
+        // Dead or out-of-range agents go back to sleep and drop out of the awake list
+        if (!entity->get_active_state() || distance_squared > AI_SLEEP_RADIUS * AI_SLEEP_RADIUS)
+        {
+            agent.level = AI_ASLEEP;
+            entity->is_sleeping = true;
+            entity->movement = glm::vec3(0.0f);
+
+            agent.last_position = glm::vec3(NAN);
+            this->settling.push_back(this->awake[i]);
+
+            this->awake[i] = this->awake.back();
+            this->awake.pop_back();
+            continue;
+        }
+
+        this->move_to_cell(this->awake[i], this->cell_of(entity->get_position()));
+
+        agent.level = distance_squared <= AI_NEAR_RADIUS * AI_NEAR_RADIUS ? AI_NEAR : AI_FAR;
+
+        // Far agents keep their last movement between thinks
+        if (agent.level == AI_NEAR || (this->step_count + agent.slot) % AI_FAR_INTERVAL == 0)
+        {
+            this->thinking.push_back(entity);
+        }
+
+        i++;
+    }
+}
+
+void AISystem::think(Entity *player, int begin, int end)
+{
+    // Behaviours only write to their own agent, so any split of this range gives the same result
+    for (int i = begin; i < end; i++)
+    {
+        Entity *entity = this->thinking[i];
+        this->behaviours[entity->get_ai_type()](entity, player);
+    }
+}
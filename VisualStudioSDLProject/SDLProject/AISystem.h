@@ -0,0 +1,64 @@
+#pragma once
+#include <vector>
+#include "Entity.h"
+
+// Distances are in world units (one tile is 1.0f in every scene)
+#define AI_CELL_SIZE 4.0f
+#define AI_NEAR_RADIUS 5.0f
+#define AI_WAKE_RADIUS 8.0f
+#define AI_SLEEP_RADIUS 12.0f // larger than the wake radius so agents don't flicker at the edge
+#define AI_FAR_INTERVAL 4     // far agents think once every this many steps
+
+// Level of detail an agent is currently thinking at
+enum AILevel { AI_NEAR, AI_FAR, AI_ASLEEP };
+
+typedef void (*AIBehaviour)(Entity *agent, Entity *player);
+
+struct AIAgent
+{
+    Entity *entity;
+    AILevel level;
+    int cell;
+    int slot; // staggers far agents so they don't all think on the same step
+    glm::vec3 last_position; // while settling: where prepare() last saw it
+};
+
+class AISystem {
+private:
+    AIBehaviour behaviours[AI_TYPE_COUNT];
+
+    std::vector<AIAgent> agents;
+    std::vector<int> awake;              // indices into agents
+    std::vector<int> settling;           // sleeping agents that may still be falling; re-bucketed until they stop
+    std::vector<std::vector<int>> cells; // sleeping and awake agents bucketed by position
+    std::vector<Entity*> thinking;       // agents whose behaviour runs this step
+
+    int grid_width  = 1;
+    int grid_height = 1;
+    float left_bound = 0.0f;
+    float top_bound  = 0.0f;
+
+    int step_count = 0;
+
+    int const cell_of(glm::vec3 position) const;
+    void move_to_cell(int agent_index, int new_cell);
+    void wake_near(glm::vec3 position);
+    void settle();
+
+public:
+    AISystem();
+
+    void register_behaviour(AIType type, AIBehaviour behaviour);
+    void build(Map *map);
+    void add(Entity *agent);
+    void clear();
+    void update(Entity *player);
+
+    // update() in two halves: the bookkeeping, then the behaviours, which can be split across jobs
+    void prepare(Entity *player);
+    void think(Entity *player, int begin, int end);
+
+    int const get_agent_count() const { return (int) this->agents.size(); }
+    int const get_awake_count() const { return (int) this->awake.size();  }
+    int const get_thinking_count() const { return (int) this->thinking.size(); }
+};
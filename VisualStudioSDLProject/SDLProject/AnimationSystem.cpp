@@ -0,0 +1,93 @@
+#include "AnimationSystem.h"
+#include "Entity.h"
+
+void AnimationSystem::add(Entity *entity)
+{
+    // Entities without a clip yet are registered all the same; the sweep skips them until they get one
+    AnimationState state;
+    state.indices   = entity->animation_indices;
+    state.frames    = entity->animation_frames;
+    state.index     = entity->animation_index;
+    state.time      = entity->animation_time;
+    state.cols      = entity->animation_cols;
+    state.rows      = entity->animation_rows;
+    state.moving    = glm::length(entity->movement) != 0;
+
+    entity->animations     = this;
+    entity->animation_slot = (int) this->states.size();
+
+    this->states.push_back(state);
+    this->uv_rects.push_back(glm::vec4(0.0f));
+
+    // Only the new slot, so the entity can render before the first step
+    this->update_uv_rect(entity->animation_slot);
+}
+
+void AnimationSystem::clear()
+{
+    this->states.clear();
+    this->uv_rects.clear();
+}
+
+void AnimationSystem::set_clip(int slot, int *indices)
+{
+    this->states[slot].indices = indices;
+    this->update_uv_rect(slot);
+}
+
+void AnimationSystem::start_attack(int slot, int *indices)
+{
+    AnimationState &state = this->states[slot];
+    state.indices   = indices;
+    state.index     = 0;
+    state.attacking = true;
+
+    this->update_uv_rect(slot);
+}
+
+void AnimationSystem::advance(float delta_time)
+{
+    this->advance_range(delta_time, 0, this->get_count());
+}
+
+void AnimationSystem::advance_range(float delta_time, int begin, int end)
+{
+    float seconds_per_frame = (float) 1 / Entity::SECONDS_PER_FRAME;
+
+    for (int i = begin; i < end; i++)
+    {
+        AnimationState &state = this->states[i];
+        if (state.indices == NULL) continue;
+
+        state.time += state.moving || state.attacking ? delta_time : 0.0f;
+
+        if (state.time >= seconds_per_frame)
+        {
+            state.time = 0.0f;
+            state.index++;
+
+            if (state.index >= state.frames)
+            {
+                state.index     = 0;
+                state.attacking = false;
+            }
+        }
+
+        this->update_uv_rect(i);
+    }
+}
+
+void AnimationSystem::update_uv_rect(int slot)
+{
+    const AnimationState &state = this->states[slot];
+    if (state.indices == NULL) return;
+
+    int frame = state.indices[state.index];
+
+    float width  = 1.0f / (float) state.cols;
+    float height = 1.0f / (float) state.rows;
+
+    this->uv_rects[slot] = glm::vec4((float) (frame % state.cols) * width,
+                                     (float) (frame / state.cols) * height,
+                                     width, height);
+}
@@ -0,0 +1,48 @@
+#pragma once
+#include <vector>
+#include "glm/vec4.hpp"
+
+class Entity;
+
+/**
+ Everything about one entity's animation once it's registered. The system owns it from then on:
+ input and AI change clips through the Entity methods that forward here, and the per-step sweep
+ walks this one contiguous array without touching the entities themselves.
+ */
+struct AnimationState
+{
+    int  *indices   = NULL; // NULL until the entity has a clip; skipped by the sweep
+    int   frames    = 0;
+    int   index     = 0;
+    float time      = 0.0f;
+    int   cols      = 1;
+    int   rows      = 1;
+    bool  moving    = false; // written by the entity's own update
+    bool  attacking = false; // an attack clip playing through once
+};
+
+class AnimationSystem {
+private:
+    std::vector<AnimationState> states;
+    std::vector<glm::vec4>      uv_rects; // u, v, width, height of the current frame
+
+    void update_uv_rect(int slot);
+
+public:
+    // Takes over the entity's clip, frame and timing as they are now
+    void add(Entity *entity);
+    void clear();
+    void advance(float delta_time);
+    void advance_range(float delta_time, int begin, int end); // slots are independent, so ranges can run in parallel
+
+    void set_clip(int slot, int *indices);
+    void start_attack(int slot, int *indices); // from the first frame, once, then flags the attack over
+    void set_moving(int slot, bool moving) { this->states[slot].moving = moving; }
+
+    bool const has_clip(int slot)     const { return this->states[slot].indices != NULL; }
+    bool const is_attacking(int slot) const { return this->states[slot].attacking; }
+    glm::vec4 const &get_uv_rect(int slot) const { return this->uv_rects[slot]; }
+
+    int const get_count() const { return (int) this->states.size(); }
+    std::vector<glm::vec4> const &get_uv_rects() const { return this->uv_rects; }
+};
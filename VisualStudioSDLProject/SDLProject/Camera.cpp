@@ -0,0 +1,72 @@
+#include "Camera.h"
+
+Camera::Camera(float half_width, float half_height) : half_width(half_width), half_height(half_height) {}
+
+void Camera::set_dead_zone(float half_width, float half_height)
+{
+    this->dead_zone_half_width  = half_width;
+    this->dead_zone_half_height = half_height;
+}
+
+// Keeps one axis of the view inside [low, high], or centres it when the map is smaller than the view
+static float clamp_axis(float centre, float half_view, float low, float high)
+{
+    if (high - low <= 2.0f * half_view) return (low + high) / 2.0f;
+
+    if (centre < low + half_view)  return low + half_view;
+    if (centre > high - half_view) return high - half_view;
+    return centre;
+}
+
+glm::vec3 const Camera::get_goal(glm::vec3 target, const Map *map) const
+{
+    glm::vec3 goal = this->position;
+
+    // Only move far enough to bring the target back to the edge of the dead zone
+    if (target.x > goal.x + this->dead_zone_half_width)  goal.x = target.x - this->dead_zone_half_width;
+    if (target.x < goal.x - this->dead_zone_half_width)  goal.x = target.x + this->dead_zone_half_width;
+    if (target.y > goal.y + this->dead_zone_half_height) goal.y = target.y - this->dead_zone_half_height;
+    if (target.y < goal.y - this->dead_zone_half_height) goal.y = target.y + this->dead_zone_half_height;
+
+    if (map != NULL)
+    {
+        goal.x = clamp_axis(goal.x, this->half_width,  map->get_left_bound(),   map->get_right_bound());
+        goal.y = clamp_axis(goal.y, this->half_height, map->get_bottom_bound(), map->get_top_bound());
+    }
+
+    return goal;
+}
+
+void Camera::snap(glm::vec3 target, const Map *map)
+{
+    this->position = target;
+    this->position = this->get_goal(target, map);
+}
+
+void Camera::follow(glm::vec3 target, const Map *map, float delta_time)
+{
+    glm::vec3 goal = this->get_goal(target, map);
+
+    if (this->smoothing <= 0.0f)
+    {
+        this->position = goal;
+        return;
+    }
+
+    // Exponential ease: closes the same share of the gap per second whatever the step length
+    this->position += (goal - this->position) * (1.0f - expf(-this->smoothing * delta_time));
+}
+
+glm::mat4 const Camera::get_view_matrix() const
+{
+    return glm::translate(glm::mat4(1.0f), glm::vec3(-this->position.x, -this->position.y, 0.0f));
+}
+
+VisibleRect const Camera::get_visible_rect() const
+{
+    VisibleRect rect = {
+        this->position.x - this->half_width,  this->position.x + this->half_width,
+        this->position.y - this->half_height, this->position.y + this->half_height
+    };
+    return rect;
+}
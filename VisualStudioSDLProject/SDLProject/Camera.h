@@ -0,0 +1,49 @@
+#pragma once
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "Map.h"
+
+/**
+ The part of the world the camera can see, in world units.
+ */
+struct VisibleRect
+{
+    float left, right, bottom, top;
+
+    bool const contains(glm::vec3 position, float margin) const
+    {
+        return position.x + margin >= left && position.x - margin <= right &&
+               position.y + margin >= bottom && position.y - margin <= top;
+    }
+};
+
+/**
+ Follows a target around the current map. The target can wander inside the dead zone without moving
+ the camera, the camera eases towards where it wants to be instead of jumping, and it never shows past
+ the map's edges (a map smaller than the view is centred instead).
+ */
+class Camera {
+private:
+    glm::vec3 position = glm::vec3(0.0f); // centre of the view
+    float half_width, half_height;        // half of what the projection shows
+
+    float dead_zone_half_width  = 0.0f;
+    float dead_zone_half_height = 0.0f;
+    float smoothing = 0.0f;                // how fast it closes the gap, per second; 0 snaps
+
+    glm::vec3 const get_goal(glm::vec3 target, const Map *map) const;
+
+public:
+    Camera(float half_width, float half_height);
+
+    void set_dead_zone(float half_width, float half_height);
+    void set_smoothing(float smoothing) { this->smoothing = smoothing; }
+
+    // Moves straight to the target, e.g. when a scene starts
+    void snap(glm::vec3 target, const Map *map);
+    void follow(glm::vec3 target, const Map *map, float delta_time);
+
+    glm::mat4   const get_view_matrix()  const;
+    VisibleRect const get_visible_rect() const;
+    glm::vec3   const get_position()     const { return this->position; }
+};
@@ -11,6 +11,10 @@
 #include "glm/gtc/matrix_transform.hpp"
 #include "ShaderProgram.h"
 #include "Entity.h"
+#include "Pathfinder.h"
+#include "VisibilitySystem.h"
+#include "AnimationSystem.h"
+#include "Utility.h"
 
 Entity::Entity()
 {
@@ -24,21 +28,6 @@ Entity::Entity()
     model_matrix = glm::mat4(1.0f);
 }
 
-Entity::~Entity()
-{
-    delete [] animation_up;
-    delete [] animation_down;
-    delete [] animation_left;
-    delete [] animation_right;
-    delete [] walking;
-
-    delete[] attacking_up;
-    delete[] attacking_down;
-    delete[] attacking_left;
-    delete[] attacking_right;
-    delete[] attacking;
-}
-
 void Entity::draw_sprite_from_texture_atlas(ShaderProgram *program, GLuint texture_id, int index)
 {
     // Step 1: Calculate the UV location of the indexed frame
@@ -49,7 +38,33 @@ void Entity::draw_sprite_from_texture_atlas(ShaderProgram *program, GLuint textu
     float width = 1.0f / (float) animation_cols;
     float height = 1.0f / (float) animation_rows;
     
-    // Step 3: Just as we have done before, match the texture coordinates to the vertices
+    draw_sprite_from_uv_rect(program, texture_id, glm::vec4(u_coord, v_coord, width, height));
+}
+
+void Entity::submit_quad(ShaderProgram *program, GLuint texture_id, const float *vertices, const float *tex_coords)
+{
+    // Moved into the world here, so every sprite can share one draw call with its neighbours
+    float *out = Utility::get_render_queue().submit(SPRITE_LAYER, program, texture_id, 0, 6);
+    
+    for (int i = 0; i < 6; i++)
+    {
+        glm::vec4 corner = model_matrix * glm::vec4(vertices[i * 2], vertices[i * 2 + 1], 0.0f, 1.0f);
+        
+        out[i * 4]     = corner.x;
+        out[i * 4 + 1] = corner.y;
+        out[i * 4 + 2] = tex_coords[i * 2];
+        out[i * 4 + 3] = tex_coords[i * 2 + 1];
+    }
+}
+
+void Entity::draw_sprite_from_uv_rect(ShaderProgram *program, GLuint texture_id, glm::vec4 uv_rect)
+{
+    float u_coord = uv_rect.x;
+    float v_coord = uv_rect.y;
+    float width   = uv_rect.z;
+    float height  = uv_rect.w;
+    
+    // Match the texture coordinates to the vertices
     float tex_coords[] =
     {
         u_coord, v_coord + height, u_coord + width, v_coord + height, u_coord + width, v_coord,
@@ -62,19 +77,7 @@ void Entity::draw_sprite_from_texture_atlas(ShaderProgram *program, GLuint textu
         -0.5, -0.5, 0.5,  0.5, -0.5, 0.5
     };
     
-    // Step 4: And render
-    glBindTexture(GL_TEXTURE_2D, texture_id);
-    
-    glVertexAttribPointer(program->positionAttribute, 2, GL_FLOAT, false, 0, vertices);
-    glEnableVertexAttribArray(program->positionAttribute);
-    
-    glVertexAttribPointer(program->texCoordAttribute, 2, GL_FLOAT, false, 0, tex_coords);
-    glEnableVertexAttribArray(program->texCoordAttribute);
-    
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    
-    glDisableVertexAttribArray(program->positionAttribute);
-    glDisableVertexAttribArray(program->texCoordAttribute);
+    submit_quad(program, texture_id, vertices, tex_coords);
 }
 
 void Entity::activate_ai(Entity *player)
@@ -107,22 +110,17 @@ void Entity::ai_guard(Entity *player)
             
             break;
         case BACK_AWAY:
-            if (position.x < 20) movement.x = 1.0f;
+            // Around whatever is in the way when the scene has planned a route, straight right otherwise
+            if (!route.empty()) movement = follow_route();
+            else if (position.x < 20) movement.x = 1.0f;
             break;
             
         case WALKING:
-            if (position.x > player->get_position().x) {
-                movement.x = -1.0f;
-                animation_indices = walking[LEFT];
+            movement = chase_direction(player);
+            if (movement.x < 0) {
+                set_animation(walking[LEFT]);
             } else {
-                movement.x = 1.0f;
-                animation_indices = walking[RIGHT];
-            }
-            if (position.y > player->get_position().y) {
-                movement.y = - 1.0f;
-            }
-            else {
-                movement.y = 1.0f;
+                set_animation(walking[RIGHT]);
             }
             break;
             
@@ -142,23 +140,16 @@ void Entity::ai_striga(Entity* player)
             invincible == true;
             ai_state = WEAK;
         }
-        if (position.x > player->get_position().x) {
-            animation_indices = walking[LEFT];
-            movement.x = -1.0f;
+        movement = chase_direction(player);
+        if (movement.x < 0) {
+            set_animation(walking[LEFT]);
         }
         else {
-            animation_indices = walking[RIGHT];
-            movement.x = 1.0f;
-        }
-        if (position.y > player->get_position().y) {
-            movement.y = -1.0f;
-        }
-        else {
-            movement.y = 1.0f;
+            set_animation(walking[RIGHT]);
         }
         break;
     case WEAK:
-        animation_indices = walking[UP];
+        set_animation(walking[UP]);
         movement.x = -1.0f;
         movement.y = 0.0f;
         speed = 0.2f;
@@ -167,22 +158,81 @@ void Entity::ai_striga(Entity* player)
     case ENRAGED:
         invincible = false;
         speed = 2.0f;
-        if (position.x > player->get_position().x) {
-            movement.x = -1.0f;
-        }
-        else {
-            movement.x = 1.0f;
-        }
-        if (position.y > player->get_position().y) {
-            movement.y = -1.0f;
-        }
-        else {
-            movement.y = 1.0f;
-        }
+        movement = chase_direction(player);
         break;
     }
 }
 
+glm::vec3 const Entity::chase_direction(Entity *player) const
+{
+    // Follow the shared flow field around walls when there is one
+    if (pathfinder != NULL)
+    {
+        glm::vec3 direction = pathfinder->get_flow_direction(position);
+        
+        // Scaled so the larger axis is 1, like the straight chase below: a diagonal step is (±1, ±1)
+        // and chasers keep their old speed
+        float largest = fmax(fabs(direction.x), fabs(direction.y));
+        if (largest != 0) return direction / largest;
+    }
+    
+    // Same tile as the player (or no field): head straight for them
+    glm::vec3 direction = glm::vec3(0.0f);
+    direction.x = position.x > player->get_position().x ? -1.0f : 1.0f;
+    direction.y = position.y > player->get_position().y ? -1.0f : 1.0f;
+    return direction;
+}
+
+glm::vec3 Entity::follow_route()
+{
+    // Waypoints are tile centres; each one counts as reached a little before the centre
+    while (route_step < route.size())
+    {
+        glm::vec3 offset = route[route_step] - position;
+        if (fabs(offset.x) > ROUTE_ARRIVE_DISTANCE || fabs(offset.y) > ROUTE_ARRIVE_DISTANCE) break;
+        route_step++;
+    }
+    
+    if (route_step >= route.size()) return glm::vec3(0.0f);
+    
+    // Same scaling as chase_direction, so following a route is no slower than chasing
+    glm::vec3 direction = route[route_step] - position;
+    direction.z = 0.0f;
+    
+    float largest = fmax(fabs(direction.x), fabs(direction.y));
+    if (largest == 0) return glm::vec3(0.0f);
+    return direction / largest;
+}
+
+void Entity::set_animation(int *indices)
+{
+    if (animations != NULL) animations->set_clip(animation_slot, indices);
+    else animation_indices = indices;
+}
+
+void Entity::start_attack_animation(int *indices)
+{
+    if (animations != NULL)
+    {
+        animations->start_attack(animation_slot, indices);
+        return;
+    }
+    
+    animation_indices = indices;
+    animation_index   = 0;
+}
+
+bool const Entity::is_attack_animating() const
+{
+    return animations != NULL && animations->is_attacking(animation_slot);
+}
+
+glm::vec4 const Entity::get_animation_uv() const
+{
+    if (animations == NULL) return glm::vec4(0.0f);
+    return animations->get_uv_rect(animation_slot);
+}
+
 void Entity::take_damage(int damage_amount)
 {
     // ADDITION? feels like !hostile == god
@@ -192,17 +242,29 @@ void Entity::take_damage(int damage_amount)
     }
 }
 
+void Entity::emit(GameEventType type, Entity *target, int amount)
+{
+    GameEvent event = { type, this, target, amount };
+    
+    if (this->events != NULL) this->events->emit(event);
+    else EventBus::apply(event, NULL);
+}
+
 void Entity::update(float delta_time, Entity* player, Entity* objects, int object_count, Map* map)
 {
     if (health <= 0) { is_active = false; }
-    if (!is_active) return;
+    if (!is_active)
+    {
+        if (animations != NULL) animations->set_moving(animation_slot, false);
+        return;
+    }
  
     collided_top    = false;
     collided_bottom = false;
     collided_left   = false;
     collided_right  = false;
     
-    if (entity_type == ENEMY) activate_ai(player);
+    if (entity_type == ENEMY && !ai_scheduled) activate_ai(player);
     
     // Our character moves from left to right, so they need an initial velocity
     velocity.x = movement.x * speed;
@@ -231,28 +293,21 @@ void Entity::update(float delta_time, Entity* player, Entity* objects, int objec
     
     model_matrix = glm::mat4(1.0f);
     model_matrix = glm::translate(model_matrix, position);
-
-    // Animations
-    if (animation_indices != NULL)
+    
+    // Walk cycles only play while moving; the frames themselves are stepped by AnimationSystem::advance
+    if (animations != NULL) animations->set_moving(animation_slot, glm::length(movement) != 0);
+    
+    if (visibility != NULL)
     {
-        if (glm::length(movement) != 0 || is_attacking_index)
+        int cell = visibility->cell_of(position);
+        if (cell != visibility_cell)
         {
-            animation_time += delta_time;
-            float frames_per_second = (float)1 / SECONDS_PER_FRAME;
-
-            if (animation_time >= frames_per_second)
-            {
-                animation_time = 0.0f;
-                animation_index++;
-
-                if (animation_index >= animation_frames)
-                {
-                    is_attacking_index = false;
-                    animation_index = 0;
-                }
-            }
+            visibility_cell = cell;
+            emit(CELL_EVENT, this, cell);
         }
     }
+    
+    // Animations are advanced for every entity at once by AnimationSystem::advance
 }
 
 void const Entity::check_attack_collision(Entity* collidable_entities, int collidable_entity_count, glm::vec3 hit_point)
@@ -268,7 +323,7 @@ void const Entity::check_attack_collision(Entity* collidable_entities, int colli
         if (x_distance < 0.0f && y_distance < 0.0f)
         {
             // ADDITION: A way to show has been hit? knock back?
-            collidable_entity->take_damage(attack_strength);
+            emit(HIT_EVENT, collidable_entity, attack_strength);
         }
     }
 }
@@ -283,11 +338,11 @@ void const Entity::check_collision_y(Entity *collidable_entities, int collidable
         {
             if (entity_type == PLAYER && collidable_entity->entity_type == ENEMY && !collidable_entity->hostile) // if npc, start interaction
             {
-                collidable_entity->speaking = true;
+                emit(DIALOGUE_EVENT, collidable_entity);
             }
             else if (entity_type == PLAYER && collidable_entity->entity_type == ENEMY && collidable_entity->hostile) // if hostile enemy, gets damaged
             {
-                take_damage(collidable_entity->attack_strength);
+                emit(HIT_EVENT, this, collidable_entity->attack_strength);
             }
             float y_distance = fabs(position.y - collidable_entity->position.y);
             float y_overlap = fabs(y_distance - (height / 2.0f) - (collidable_entity->height / 2.0f));
@@ -314,11 +369,11 @@ void const Entity::check_collision_x(Entity *collidable_entities, int collidable
         {
             if (entity_type == PLAYER && collidable_entity->entity_type == ENEMY && !collidable_entity->hostile) // if npc, start interaction
             {
-                collidable_entity->speaking = true;
+                emit(DIALOGUE_EVENT, collidable_entity);
             }
             else if (entity_type == PLAYER && collidable_entity->entity_type == ENEMY && collidable_entity->hostile) // if hostile enemy, gets damaged
             {
-                take_damage(collidable_entity->attack_strength);
+                emit(HIT_EVENT, this, collidable_entity->attack_strength);
             }
             float x_distance = fabs(position.x - collidable_entity->position.x);
             float x_overlap = fabs(x_distance - (width / 2.0f) - (collidable_entity->width / 2.0f));
@@ -393,9 +448,14 @@ void Entity::render(ShaderProgram *program)
 {
     if (!is_active) return;
     
-    program->SetModelMatrix(model_matrix);
+    if (animations != NULL && animations->has_clip(animation_slot))
+    {
+        draw_sprite_from_uv_rect(program, texture_id, animations->get_uv_rect(animation_slot));
+        return;
+    }
     
-    if (animation_indices != NULL)
+    // Not in an AnimationSystem: its starting frame, straight from the atlas
+    if (animations == NULL && animation_indices != NULL)
     {
         draw_sprite_from_texture_atlas(program, texture_id, animation_indices[animation_index]);
         return;
@@ -404,17 +464,7 @@ void Entity::render(ShaderProgram *program)
     float vertices[]   = { -0.5, -0.5, 0.5, -0.5, 0.5, 0.5, -0.5, -0.5, 0.5, 0.5, -0.5, 0.5 };
     float tex_coords[] = {  0.0,  1.0, 1.0,  1.0, 1.0, 0.0,  0.0,  1.0, 1.0, 0.0,  0.0, 0.0 };
     
-    glBindTexture(GL_TEXTURE_2D, texture_id);
-    
-    glVertexAttribPointer(program->positionAttribute, 2, GL_FLOAT, false, 0, vertices);
-    glEnableVertexAttribArray(program->positionAttribute);
-    glVertexAttribPointer(program->texCoordAttribute, 2, GL_FLOAT, false, 0, tex_coords);
-    glEnableVertexAttribArray(program->texCoordAttribute);
-    
-    glDrawArrays(GL_TRIANGLES, 0, 6);
-    
-    glDisableVertexAttribArray(program->positionAttribute);
-    glDisableVertexAttribArray(program->texCoordAttribute);
+    submit_quad(program, texture_id, vertices, tex_coords);
 }
 
 bool const Entity::check_collision(Entity *other) const
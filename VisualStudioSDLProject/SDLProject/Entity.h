@@ -1,8 +1,16 @@
 #pragma once
+#include <vector>
 #include "Map.h"
+#include "EventBus.h"
+
+#define ROUTE_ARRIVE_DISTANCE 0.1f // how near a waypoint has to be, on both axes, before heading for the next
+
+class Pathfinder;
+class VisibilitySystem;
+class AnimationSystem;
 
 enum EntityType { PLATFORM, PLAYER, ENEMY };
-enum AIType     { WALKER, GUARD, STRIGA           };
+enum AIType     { WALKER, GUARD, STRIGA, AI_TYPE_COUNT }; // AI_TYPE_COUNT stays last
 enum AIState    { WALKING, IDLE, ATTACKING, BACK_AWAY, WEAK, ENRAGED };
 
 class Entity
@@ -13,16 +21,6 @@ private:
     AIType ai_type;
     AIState ai_state;
     
-    int *animation_right = NULL; // move to the right
-    int *animation_left  = NULL; // move to the left
-    int *animation_up    = NULL; // move upwards
-    int *animation_down  = NULL; // move downwards
-
-    int* attacking_left = NULL;
-    int* attacking_right = NULL;
-    int* attacking_up = NULL;
-    int* attacking_down = NULL;
-    
     glm::vec3 position;
     glm::vec3 velocity;
     glm::vec3 acceleration;
@@ -51,14 +49,20 @@ public:
     glm::vec3 movement;
     
     // Animating
-    int **walking          = new int*[4] { animation_left, animation_right, animation_up, animation_down };
-    int** attacking = new int* [4]{ attacking_left, attacking_right, attacking_up, attacking_down };
+    // Frame tables indexed by LEFT/RIGHT/UP/DOWN; the arrays belong to the scene's arena
+    int *walking[4]        = { NULL, NULL, NULL, NULL };
+    int *attacking[4]      = { NULL, NULL, NULL, NULL };
+    
+    // How the animation starts out. Once AnimationSystem::add has the entity, the system owns the
+    // playing state; change it through set_animation and start_attack_animation
     int *animation_indices = NULL;
     int animation_frames   = 0;
     int animation_index    = 0;
     float animation_time   = 0.0f;
     int animation_cols     = 0;
     int animation_rows     = 0;
+    AnimationSystem *animations = NULL;
+    int animation_slot = -1;
     glm::vec3 orientation;
     
     // Jumping
@@ -73,7 +77,6 @@ public:
 
     // Attacking
     bool is_attacking = false;
-    bool is_attacking_index = false;
     float attack_range = 0.25f;
     int attack_frame = 0;
 
@@ -82,6 +85,27 @@ public:
     bool invincible = false;
     bool speaking = false; // ADDITION: need better way to distinguish this
 
+    // Scheduling (set by AISystem)
+    bool ai_scheduled = false; // behaviour is run by AISystem rather than from update
+    bool is_sleeping  = false; // too far from the player for its AI to run; physics still does
+
+    // Chasing; NULL falls back to heading straight for the player
+    Pathfinder *pathfinder = NULL;
+    
+    // Waypoints from Pathfinder::find_path for behaviours heading somewhere other than the player
+    std::vector<glm::vec3> route;
+    size_t route_step = 0;
+
+    // Hits and dialogue on other entities go here during a step; NULL applies them immediately
+    EventBus *events = NULL;
+    int event_order = 0; // where this entity's events go when the bus resolves; set by EventBus::attach
+    
+    // Culling grid this entity is bucketed in, set by VisibilitySystem::add. The entity reports crossing
+    // into another cell as it moves, so culling never has to look at entities off screen
+    VisibilitySystem *visibility = NULL;
+    int visibility_index = -1;
+    int visibility_cell  = -1; // last cell reported
+
     // Decisions
     int decision = 0;
     /*
@@ -92,18 +116,28 @@ public:
 
     // Methods
     Entity();
-    ~Entity();
 
     void draw_sprite_from_texture_atlas(ShaderProgram *program, GLuint texture_id, int index);
+    void draw_sprite_from_uv_rect(ShaderProgram *program, GLuint texture_id, glm::vec4 uv_rect);
+    void submit_quad(ShaderProgram *program, GLuint texture_id, const float *vertices, const float *tex_coords);
     void update(float delta_time, Entity *player, Entity *objects, int object_count, Map *map);
     void render(ShaderProgram *program);
     void activate_ai(Entity *player);
     void ai_walker();
     void ai_guard(Entity *player);
     void ai_striga(Entity* player);
+    glm::vec3 const chase_direction(Entity *player) const;
+    glm::vec3 follow_route();
+    
+    // Animation
+    void set_animation(int *indices);
+    void start_attack_animation(int *indices);
+    bool const is_attack_animating() const;
+    glm::vec4 const get_animation_uv() const;
 
     // Damage related
     void take_damage(int damage_amount);
+    void emit(GameEventType type, Entity *target, int amount = 0);
     
     void const check_attack_collision(Entity* collidable_entities, int collidable_entity_count, glm::vec3 hit_point);
     void const check_collision_y(Entity *collidable_entities, int collidable_entity_count);
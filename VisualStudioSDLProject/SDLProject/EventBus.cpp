@@ -0,0 +1,92 @@
+#include "EventBus.h"
+#include <algorithm>
+#include <assert.h>
+#include "Entity.h"
+#include "VisibilitySystem.h"
+#include "WorkStealingPool.h"
+
+void EventBus::attach(Entity *entity)
+{
+    entity->events = this;
+    entity->event_order = this->attached++;
+}
+
+void EventBus::set_pool(const WorkStealingPool *pool)
+{
+    assert(pool == NULL || pool->get_thread_count() < EVENT_MAX_THREADS);
+    this->pool = pool;
+}
+
+void EventBus::emit(GameEvent event)
+{
+    int slot = this->pool != NULL ? this->pool->get_worker_index() + 1 : 0;
+
+    this->queues[slot].events.push_back(event);
+}
+
+void EventBus::resolve()
+{
+    this->resolved.clear();
+
+    std::vector<GameEvent> merged;
+    for (int i = 0; i < EVENT_MAX_THREADS; i++)
+    {
+        merged.insert(merged.end(), this->queues[i].events.begin(), this->queues[i].events.end());
+        this->queues[i].events.clear();
+    }
+
+    // One entity is only ever updated by one thread, so its events are already in the order it
+    // emitted them; a stable sort on the emitter's attach order puts everything in the order a
+    // serial update would have produced, whichever queues they arrived in
+    std::stable_sort(merged.begin(), merged.end(), [](const GameEvent &a, const GameEvent &b) {
+        return a.source->event_order < b.source->event_order;
+    });
+
+    for (size_t i = 0; i < merged.size(); i++) EventBus::apply(merged[i], &this->resolved);
+}
+
+void EventBus::clear()
+{
+    for (int i = 0; i < EVENT_MAX_THREADS; i++) this->queues[i].events.clear();
+    this->resolved.clear();
+    this->attached = 0;
+}
+
+void EventBus::apply(GameEvent event, std::vector<GameEvent> *log)
+{
+    switch (event.type)
+    {
+        case HIT_EVENT:
+        {
+            bool was_alive = event.target->get_health() > 0;
+            event.target->take_damage(event.amount);
+            if (log != NULL) log->push_back(event);
+
+            // The killing blow is reported as its own event
+            if (was_alive && event.target->get_health() <= 0)
+            {
+                GameEvent death = { DEATH_EVENT, event.source, event.target, 0 };
+                EventBus::apply(death, log);
+            }
+            break;
+        }
+
+        case DEATH_EVENT:
+            event.target->deactivate();
+            if (log != NULL) log->push_back(event);
+            break;
+
+        case CELL_EVENT:
+            // Bookkeeping rather than gameplay, so it isn't logged
+            event.target->visibility->move_to_cell(event.target->visibility_index, event.amount);
+            break;
+            
+        case DIALOGUE_EVENT:
+            event.target->speaking = true;
+            if (log != NULL) log->push_back(event);
+            break;
+
+        default:
+            break;
+    }
+}
@@ -0,0 +1,62 @@
+#pragma once
+#include <stddef.h>
+#include <vector>
+
+#define EVENT_MAX_THREADS 64 // queues per bus: one for outside threads, one per worker of the pool it's given
+#define EVENT_QUEUE_STRIDE 64 // one cache line per queue so threads emitting side by side don't collide
+
+class Entity;
+class WorkStealingPool;
+
+enum GameEventType { HIT_EVENT, DEATH_EVENT, DIALOGUE_EVENT, CELL_EVENT };
+
+/**
+ Something one entity did to another during a step. source is whoever emitted it.
+ */
+struct GameEvent
+{
+    GameEventType type;
+    Entity *source;
+    Entity *target;
+    int amount; // damage for hits, the new visibility cell for cell events
+};
+
+/**
+ Entities don't change each other while a step is running; they emit events here instead, which lets
+ entity updates run on any number of threads. Each thread appends to its own queue without locking,
+ and once the step is over resolve() merges the queues into one order that doesn't depend on which
+ thread ran what, and applies them.
+ */
+class EventBus {
+private:
+    struct alignas(EVENT_QUEUE_STRIDE) EventQueue
+    {
+        std::vector<GameEvent> events;
+    };
+
+    EventQueue queues[EVENT_MAX_THREADS];
+    std::vector<GameEvent> resolved;
+
+    const WorkStealingPool *pool = NULL;
+    int attached = 0; // entities attached since the last clear()
+
+public:
+    // The entity emits here from now on. Attach in the order a serial step updates them: resolve()
+    // applies events in that order
+    void attach(Entity *entity);
+
+    // Whose workers may emit during a step: worker i gets queue i + 1, and every other thread shares
+    // queue 0, so only one thread outside the pool may emit at a time. It can't have more than
+    // EVENT_MAX_THREADS - 1 workers
+    void set_pool(const WorkStealingPool *pool);
+
+    void emit(GameEvent event);
+    void resolve();
+    void clear();
+
+    // What the last resolve() applied, in order, for anything that wants to react (sounds, UI)
+    std::vector<GameEvent> const &get_resolved() const { return this->resolved; }
+
+    // Applies a single event straight away, for entities that aren't attached to a bus
+    static void apply(GameEvent event, std::vector<GameEvent> *log);
+};
@@ -0,0 +1,109 @@
+#include "FramePacer.h"
+#include <ctime>
+#include <iostream>
+
+#ifdef _WINDOWS
+#include <windows.h>
+#endif
+
+// CPU time used by the whole process (every thread), not wall time
+static double process_cpu_seconds()
+{
+#ifdef _WINDOWS
+    FILETIME creation, exit, kernel, user;
+    GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user);
+
+    ULARGE_INTEGER kernel_time, user_time;
+    kernel_time.LowPart = kernel.dwLowDateTime; kernel_time.HighPart = kernel.dwHighDateTime;
+    user_time.LowPart   = user.dwLowDateTime;   user_time.HighPart   = user.dwHighDateTime;
+
+    return (double) (kernel_time.QuadPart + user_time.QuadPart) / 10000000.0; // 100 ns units
+#else
+    return (double) std::clock() / CLOCKS_PER_SEC;
+#endif
+}
+
+FramePacer::FramePacer(PacingMode mode, float frames_per_second) : mode(mode)
+{
+    this->frequency = SDL_GetPerformanceFrequency();
+    this->interval  = (Uint64) (this->frequency / frames_per_second);
+
+    if (mode == VSYNC_PACING && SDL_GL_SetSwapInterval(1) != 0)
+    {
+        std::cout << "vsync unavailable, capping at " << frames_per_second << " fps instead\n";
+        this->mode = CAPPED_PACING;
+    }
+    else if (mode != VSYNC_PACING)
+    {
+        // The cap is the only thing holding frames back
+        SDL_GL_SetSwapInterval(0);
+    }
+
+    this->report_start = (double) SDL_GetPerformanceCounter() / this->frequency;
+}
+
+void FramePacer::begin_frame()
+{
+    this->frame_cpu_start = process_cpu_seconds();
+
+    if (this->next_deadline == 0) this->next_deadline = SDL_GetPerformanceCounter() + this->interval;
+}
+
+bool const FramePacer::should_render(bool advanced) const
+{
+    return this->mode != ON_DEMAND_PACING || advanced;
+}
+
+void FramePacer::wait_until(Uint64 deadline)
+{
+    Uint64 margin = (Uint64) (FRAME_SPIN_MARGIN * this->frequency);
+
+    // SDL_Delay can oversleep by a millisecond or more, so stop sleeping a little early...
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (now + margin < deadline)
+    {
+        SDL_Delay((Uint32) ((deadline - margin - now) * 1000 / this->frequency));
+    }
+
+    // ...and spin through the rest
+    while (SDL_GetPerformanceCounter() < deadline) {}
+}
+
+void FramePacer::end_frame(bool rendered)
+{
+    if (this->mode != VSYNC_PACING)
+    {
+        this->wait_until(this->next_deadline);
+
+        // Deadlines are spaced exactly an interval apart so the rate doesn't drift; after a long stall
+        // start again from now instead of rushing frames out to catch up
+        Uint64 now = SDL_GetPerformanceCounter();
+        this->next_deadline += this->interval;
+        if (this->next_deadline < now) this->next_deadline = now + this->interval;
+    }
+
+    // Taken after the wait, so the spin counts too: this is what the frame cost the machine
+    this->last_cpu_time = (float) (process_cpu_seconds() - this->frame_cpu_start);
+    this->cpu_seconds += this->last_cpu_time;
+    this->frames++;
+    if (rendered) this->rendered++;
+
+    this->report(SDL_GetPerformanceCounter());
+}
+
+void FramePacer::report(Uint64 now)
+{
+    if (FRAME_REPORT_SECONDS <= 0.0f) return;
+
+    double elapsed = (double) now / this->frequency - this->report_start;
+    if (elapsed < FRAME_REPORT_SECONDS) return;
+
+    std::cout << "frames: " << this->frames / elapsed << "/s, drawn: " << this->rendered / elapsed
+              << "/s, cpu: " << 1000.0 * this->cpu_seconds / this->frames << " ms/frame ("
+              << 100.0 * this->cpu_seconds / elapsed << "% of a core)\n";
+
+    this->report_start += elapsed;
+    this->cpu_seconds = 0.0;
+    this->frames   = 0;
+    this->rendered = 0;
+}
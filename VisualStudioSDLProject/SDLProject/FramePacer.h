@@ -0,0 +1,45 @@
+#pragma once
+#include <SDL.h>
+
+#define FRAME_SPIN_MARGIN 0.002f    // seconds before a deadline that sleeping gives way to spinning
+#define FRAME_REPORT_SECONDS 0.0f   // seconds between frame reports; 0 leaves them off
+
+/**
+ VSYNC_PACING lets SDL_GL_SwapWindow block until the display is ready (falling back to CAPPED_PACING
+ if the driver won't). CAPPED_PACING sleeps off most of each frame and spins only the last couple of
+ milliseconds, for an exact rate without burning a core. ON_DEMAND_PACING is capped too, but frames
+ where the simulation didn't move aren't drawn at all.
+ */
+enum PacingMode { VSYNC_PACING, CAPPED_PACING, ON_DEMAND_PACING };
+
+class FramePacer {
+private:
+    PacingMode mode;
+    Uint64 frequency;
+    Uint64 interval;      // performance-counter ticks per frame when capped
+    Uint64 next_deadline = 0;
+
+    double frame_cpu_start = 0.0;
+
+    // Running totals since the last report
+    double report_start = 0.0;
+    double cpu_seconds  = 0.0;
+    int frames   = 0;
+    int rendered = 0;
+
+    float last_cpu_time = 0.0f;
+
+    void wait_until(Uint64 deadline);
+    void report(Uint64 now);
+
+public:
+    // Call with the GL context current; the swap interval is set on it
+    FramePacer(PacingMode mode, float frames_per_second);
+
+    void begin_frame();
+    bool const should_render(bool advanced) const;
+    void end_frame(bool rendered);
+
+    PacingMode const get_mode()     const { return this->mode; }
+    float      const get_cpu_time() const { return this->last_cpu_time; } // process CPU seconds the last frame cost
+};
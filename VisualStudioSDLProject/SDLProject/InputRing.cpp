@@ -0,0 +1,44 @@
+#include "InputRing.h"
+#include <chrono>
+
+InputRing::InputRing() : head(0), tail(0) {}
+
+bool InputRing::push(const InputEvent &event)
+{
+    unsigned tail = this->tail.load(std::memory_order_relaxed);
+    if (tail - this->head.load(std::memory_order_acquire) == INPUT_RING_CAPACITY) return false;
+
+    this->events[tail & (INPUT_RING_CAPACITY - 1)] = event;
+
+    // Publishes the slot written above
+    this->tail.store(tail + 1, std::memory_order_release);
+
+    // Taking the lock means a consumer between its check and its wait can't miss this
+    { std::lock_guard<std::mutex> guard(this->sleep_lock); }
+    this->arrived.notify_one();
+    return true;
+}
+
+bool InputRing::peek(InputEvent &event) const
+{
+    unsigned head = this->head.load(std::memory_order_relaxed);
+    if (head == this->tail.load(std::memory_order_acquire)) return false;
+
+    event = this->events[head & (INPUT_RING_CAPACITY - 1)];
+    return true;
+}
+
+bool InputRing::wait(int timeout_ms)
+{
+    std::unique_lock<std::mutex> guard(this->sleep_lock);
+
+    return this->arrived.wait_for(guard, std::chrono::milliseconds(timeout_ms), [this]() {
+        return this->head.load(std::memory_order_relaxed) != this->tail.load(std::memory_order_acquire);
+    });
+}
+
+void InputRing::pop()
+{
+    // Hands the slot back to the producer
+    this->head.store(this->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <SDL.h>
+
+#define INPUT_RING_CAPACITY 256 // a power of two, so wrapping an index is a mask
+#define INPUT_RING_STRIDE 64    // head and tail each get their own cache line
+
+/**
+ One keyboard, window or quit event, stamped with SDL_GetPerformanceCounter() the moment the input thread
+ picked it up.
+ */
+struct InputEvent
+{
+    Uint64 timestamp;
+    Uint32 type;
+    SDL_Keycode key;
+    int scancode;
+};
+
+/**
+ Lock-free queue from exactly one producer (the thread pumping SDL events) to exactly one consumer
+ (the simulation). Each side only writes its own index, so all it takes is an acquire/release pair.
+ */
+class InputRing {
+private:
+    InputEvent events[INPUT_RING_CAPACITY];
+
+    alignas(INPUT_RING_STRIDE) std::atomic<unsigned> head; // next slot the consumer reads
+    alignas(INPUT_RING_STRIDE) std::atomic<unsigned> tail; // next slot the producer writes
+
+    // Only for a consumer with nothing to do; push and pop never take the lock
+    std::mutex sleep_lock;
+    std::condition_variable arrived;
+
+public:
+    InputRing();
+
+    // Producer only. False when the ring is full; the event is not queued
+    bool push(const InputEvent &event);
+
+    // Consumer only. Looks at the oldest event without taking it
+    bool peek(InputEvent &event) const;
+    void pop();
+
+    // Consumer only. Sleeps until something is queued or timeout_ms passes; true if something is queued
+    bool wait(int timeout_ms);
+};
@@ -0,0 +1,64 @@
+#include "JobGraph.h"
+
+int JobGraph::add(std::function<void()> job)
+{
+    this->nodes.emplace_back();
+    this->nodes.back().job = job;
+
+    return (int) this->nodes.size() - 1;
+}
+
+void JobGraph::add_dependency(int job, int dependency)
+{
+    if (dependency < 0) return;
+
+    this->nodes[dependency].dependents.push_back(job);
+    this->nodes[job].dependency_count++;
+}
+
+int JobGraph::add_range(int count, int grain, std::function<void(int begin, int end)> body, int after)
+{
+    int join = this->add([] {});
+
+    if (count == 0) this->add_dependency(join, after);
+
+    for (int begin = 0; begin < count; begin += grain)
+    {
+        int end = begin + grain < count ? begin + grain : count;
+        int chunk = this->add([body, begin, end] { body(begin, end); });
+
+        this->add_dependency(chunk, after);
+        this->add_dependency(join, chunk);
+    }
+
+    return join;
+}
+
+void JobGraph::submit(WorkStealingPool &pool, int node)
+{
+    pool.submit([this, &pool, node] {
+        JobNode &finished = this->nodes[node];
+        finished.job();
+
+        // Whoever finishes a job's last dependency is the one who releases it
+        for (size_t i = 0; i < finished.dependents.size(); i++)
+        {
+            int dependent = finished.dependents[i];
+            if (--this->nodes[dependent].remaining == 0) this->submit(pool, dependent);
+        }
+    });
+}
+
+void JobGraph::run(WorkStealingPool &pool)
+{
+    for (size_t i = 0; i < this->nodes.size(); i++) this->nodes[i].remaining = this->nodes[i].dependency_count;
+
+    for (size_t i = 0; i < this->nodes.size(); i++)
+    {
+        if (this->nodes[i].dependency_count == 0) this->submit(pool, (int) i);
+    }
+
+    // Released jobs are submitted before the job that released them counts as finished, so the pool
+    // can't run dry until the whole graph has
+    pool.wait();
+}
@@ -0,0 +1,39 @@
+#pragma once
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <vector>
+#include "WorkStealingPool.h"
+
+/**
+ Jobs plus the order they have to finish in. A job is handed to the pool as soon as everything it
+ depends on is done, so independent work (say, two halves of the enemy list) runs side by side while
+ dependent phases still see each other's results exactly as the serial code would.
+ */
+class JobGraph {
+private:
+    struct JobNode
+    {
+        std::function<void()> job;
+        std::vector<int> dependents;
+        int dependency_count = 0;
+        std::atomic<int> remaining;
+    };
+
+    std::deque<JobNode> nodes; // deque so nodes never move while jobs hold on to them
+
+    void submit(WorkStealingPool &pool, int node);
+
+public:
+    int add(std::function<void()> job);
+    void add_dependency(int job, int dependency);
+
+    // Splits [0, count) into chunks of at most grain items, each run after `after` (-1 for none). Returns
+    // an empty job that finishes once every chunk has, for later phases to depend on.
+    int add_range(int count, int grain, std::function<void(int begin, int end)> body, int after);
+
+    void run(WorkStealingPool &pool);
+    void clear() { this->nodes.clear(); }
+
+    int const get_job_count() const { return (int) this->nodes.size(); }
+};
@@ -1,22 +1,270 @@
+#include <algorithm>
+#include <memory>
 #include "Map.h"
+#include "StaticLevel.h"
+#include "Utility.h"
 
-Map::Map(int width, int height, unsigned int *level_data, GLuint texture_id, float tile_size, int tile_count_x, int tile_count_y)
+Map::Map(int width, int height, const unsigned int *level_data, GLuint texture_id, float tile_size, int tile_count_x, int tile_count_y, MapRenderMode render_mode)
+{
+    this->initialise(width, height, level_data, texture_id, tile_size, tile_count_x, tile_count_y, render_mode);
+}
+
+Map::Map(const StaticLevelData &level, GLuint texture_id, float tile_size, int tile_count_y, MapRenderMode render_mode)
+{
+    this->prebuilt = level;
+    this->initialise(level.width, level.height, level.tiles, texture_id, tile_size, level.tile_count_x, tile_count_y, render_mode);
+}
+
+void Map::initialise(int width, int height, const unsigned int *level_data, GLuint texture_id, float tile_size, int tile_count_x, int tile_count_y, MapRenderMode render_mode)
 {
     this->width = width;
     this->height = height;
     
-    this->level_data = level_data;
+    this->tiles.assign(level_data, level_data + width * height);
+    this->level_data = this->tiles.data();
     this->texture_id = texture_id;
     
     this->tile_size = tile_size;
     this->tile_count_x = tile_count_x;
     this->tile_count_y = tile_count_y;
+    this->render_mode = render_mode;
     
     this->build();
 }
 
+Map::~Map()
+{
+    if (this->index_texture_id != 0) glDeleteTextures(1, &this->index_texture_id);
+    if (this->run_buffer != 0)       glDeleteBuffers(1, &this->run_buffer);
+}
+
 void Map::build()
 {
+    this->run_slots = false;
+    
+    this->build_solid_bits();
+    if (this->render_mode == INDEXED_MAP_RENDER) this->build_index_texture();
+    else                                         this->build_runs();
+    
+    this->left_bound   = 0 - (this->tile_size / 2);
+    this->right_bound  = (this->tile_size * this->width) - (this->tile_size / 2);
+    this->top_bound    = 0 + (this->tile_size / 2);
+    this->bottom_bound = -(this->tile_size * this->height) + (this->tile_size / 2);
+    
+#if MAP_VERTEX_REPORT
+    // Off by default: for runtime indexed maps this is an extra merge pass just for the log line
+    int tile_vertex_count   = this->width * this->height * 6;
+    int merged_vertex_count = this->prebuilt.tiles != NULL ? this->prebuilt.run_vertex_count : this->merge_runs(NULL);
+    std::cout << "map " << this->width << "x" << this->height << ": " << tile_vertex_count << " vertices as tiles, "
+              << merged_vertex_count << " as runs (" << 100 - merged_vertex_count * 100 / tile_vertex_count << "% fewer)\n";
+#endif
+}
+
+int const Map::merge_runs(std::vector<float> *run_vertices) const
+{
+    std::unique_ptr<bool[]> merged(new bool[this->width * this->height]);
+    if (run_vertices == NULL)
+    {
+        return merge_tile_runs(this->level_data, this->width, this->height, this->tile_count_x, this->tile_size, merged.get(), nullptr);
+    }
+    
+    // Sized for the worst case, a run per tile, then cut down to what the merge used
+    run_vertices->resize(this->width * this->height * 6 * RUN_FLOATS_PER_VERTEX);
+    int vertex_count = merge_tile_runs(this->level_data, this->width, this->height, this->tile_count_x, this->tile_size,
+                                       merged.get(), run_vertices->data());
+    run_vertices->resize(vertex_count * RUN_FLOATS_PER_VERTEX);
+    
+    return vertex_count;
+}
+
+void Map::build_solid_bits()
+{
+    if (this->prebuilt.tiles != NULL)
+    {
+        this->solid_bits.assign(this->prebuilt.solid_bits, this->prebuilt.solid_bits + (this->width * this->height + 31) / 32);
+        return;
+    }
+    
+    this->solid_bits.assign((this->width * this->height + 31) / 32, 0);
+    for (int i = 0; i < this->width * this->height; i++)
+    {
+        if (this->level_data[i] > 0) this->solid_bits[i / 32] |= (uint32_t) 1 << (i % 32);
+    }
+}
+
+void Map::build_runs()
+{
+    // Runs never move, so they go to the GPU once and stay there. Built-in levels merged theirs at
+    // compile time, for tiles of size 1, which is all of them
+    std::vector<float> run_vertices;
+    const float *upload = this->prebuilt.run_vertices;
+    this->run_vertex_count = this->prebuilt.run_vertex_count;
+    
+    if (this->prebuilt.tiles == NULL || this->tile_size != 1.0f)
+    {
+        this->run_vertex_count = this->merge_runs(&run_vertices);
+        upload = run_vertices.data();
+    }
+    
+    if (this->run_buffer == 0) glGenBuffers(1, &this->run_buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, this->run_buffer);
+    glBufferData(GL_ARRAY_BUFFER, this->run_vertex_count * RUN_FLOATS_PER_VERTEX * sizeof(float), upload, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Map::build_run_slots()
+{
+    // A merged run can't lose one tile without redoing its neighbours, so the first edit trades the
+    // runs for a run per tile. Every tile then has a fixed slot, and later edits touch only theirs
+    std::vector<float> run_vertices(this->width * this->height * 6 * RUN_FLOATS_PER_VERTEX);
+    
+    for (int i = 0; i < this->width * this->height; i++)
+    {
+        write_tile_run(&run_vertices[i * 6 * RUN_FLOATS_PER_VERTEX], this->level_data[i], i % this->width, i / this->width,
+                       1, 1, this->tile_size, this->tile_count_x);
+    }
+    this->run_vertex_count = this->width * this->height * 6;
+    this->run_slots = true;
+    
+    glBindBuffer(GL_ARRAY_BUFFER, this->run_buffer);
+    glBufferData(GL_ARRAY_BUFFER, run_vertices.size() * sizeof(float), run_vertices.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+bool Map::set_tile(int tile_x, int tile_y, unsigned int tile)
+{
+    if (tile_x < 0 || tile_x >= this->width)  return false;
+    if (tile_y < 0 || tile_y >= this->height) return false;
+    
+    // Collision reads straight from these, so this alone is enough for is_solid and the pathfinder
+    int slot = tile_y * this->width + tile_x;
+    this->level_data[slot] = tile;
+    if (tile > 0) this->solid_bits[slot / 32] |=  ((uint32_t) 1 << (slot % 32));
+    else          this->solid_bits[slot / 32] &= ~((uint32_t) 1 << (slot % 32));
+    this->revision++;
+    
+    // The compile-time data no longer matches
+    this->prebuilt = StaticLevelData();
+    
+    if (this->index_texture_id != 0)
+    {
+        unsigned char texel[4] = { (unsigned char) (tile & 0xFF), (unsigned char) ((tile >> 8) & 0xFF), 0, 0 };
+        
+        glBindTexture(GL_TEXTURE_2D, this->index_texture_id);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(GL_TEXTURE_2D, 0, tile_x, this->get_collision_layer() * this->height + tile_y, 1, 1,
+                        GL_RGBA, GL_UNSIGNED_BYTE, texel);
+    }
+    
+    if (this->run_buffer != 0 && !this->run_slots)
+    {
+        this->build_run_slots();
+    }
+    else if (this->run_buffer != 0)
+    {
+        float run_vertices[6 * RUN_FLOATS_PER_VERTEX];
+        write_tile_run(run_vertices, tile, tile_x, tile_y, 1, 1, this->tile_size, this->tile_count_x);
+        
+        glBindBuffer(GL_ARRAY_BUFFER, this->run_buffer);
+        glBufferSubData(GL_ARRAY_BUFFER, slot * 6 * RUN_FLOATS_PER_VERTEX * sizeof(float), sizeof(run_vertices), run_vertices);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+    
+    // The per-tile fallback keeps every tile, so its slots line up with the tile index already
+    if (!this->texture_coordinates.empty())
+    {
+        float u = (float) (tile % this->tile_count_x) / (float) this->tile_count_x;
+        float v = (float) (tile / this->tile_count_x) / (float) this->tile_count_y;
+        float tile_width  = 1.0f / (float) this->tile_count_x;
+        float tile_height = 1.0f / (float) this->tile_count_y;
+        
+        float patch[] = { u, v, u, v + tile_height, u + tile_width, v + tile_height,
+                          u, v, u + tile_width, v + tile_height, u + tile_width, v };
+        std::copy(patch, patch + 12, this->texture_coordinates.begin() + slot * 12);
+    }
+    
+    return true;
+}
+
+bool Map::add_layer(MapLayerKind kind, const unsigned int *layer_data, float parallax)
+{
+    if (this->get_layer_count() >= MAP_MAX_LAYERS) return false;
+    
+    MapTileLayer layer;
+    layer.tiles.assign(layer_data, layer_data + this->width * this->height);
+    layer.parallax = parallax;
+    
+    if (kind == BACKGROUND_TILES) this->background_layers.push_back(layer);
+    else                          this->foreground_layers.push_back(layer);
+    
+    if (this->index_texture_id != 0) this->build_index_texture();
+    return true;
+}
+
+const unsigned int * const Map::get_layer_data(int layer) const
+{
+    int collision_layer = this->get_collision_layer();
+    
+    if (layer < collision_layer)  return this->background_layers[layer].tiles.data();
+    if (layer == collision_layer) return this->level_data;
+    return this->foreground_layers[layer - collision_layer - 1].tiles.data();
+}
+
+float const Map::get_layer_parallax(int layer) const
+{
+    int collision_layer = this->get_collision_layer();
+    
+    if (layer < collision_layer)  return this->background_layers[layer].parallax;
+    if (layer == collision_layer) return 1.0f;
+    return this->foreground_layers[layer - collision_layer - 1].parallax;
+}
+
+void Map::build_index_texture()
+{
+    // RGBA8 rather than an integer format, which the GLSL this project targets can't sample:
+    // the low byte of the tile index goes in red and the high byte in green. Texture arrays are out
+    // for the same reason, so the layers are stacked one under the other in a single texture
+    int layer_size = this->width * this->height;
+    std::vector<unsigned char> texels;
+    const unsigned char *upload = this->prebuilt.texels;
+    
+    // A built-in level has its texels already, as long as it's still the only layer
+    if (this->prebuilt.tiles == NULL || this->get_layer_count() > 1)
+    {
+        texels.assign(layer_size * this->get_layer_count() * 4, 0);
+        upload = texels.data();
+        
+        for (int layer = 0; layer < this->get_layer_count(); layer++)
+        {
+            const unsigned int *layer_data = this->get_layer_data(layer);
+            unsigned char *out = &texels[layer * layer_size * 4];
+            
+            for (int i = 0; i < layer_size; i++)
+            {
+                out[i * 4]     = layer_data[i] & 0xFF;
+                out[i * 4 + 1] = (layer_data[i] >> 8) & 0xFF;
+            }
+        }
+    }
+    
+    if (this->index_texture_id == 0) glGenTextures(1, &this->index_texture_id);
+    glBindTexture(GL_TEXTURE_2D, this->index_texture_id);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, this->width, this->height * this->get_layer_count(), 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, upload);
+    
+    // One texel per tile, so it must never be filtered or wrapped into a neighbour
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+void Map::build_vertices()
+{
+    this->vertices.clear();
+    this->texture_coordinates.clear();
+    
     for(int y = 0; y < this->height; y++)
     {
         for(int x = 0; x < this->width; x++) {
@@ -52,30 +300,39 @@ void Map::build()
             });
         }
     }
-    
-    this->left_bound   = 0 - (this->tile_size / 2);
-    this->right_bound  = (this->tile_size * this->width) - (this->tile_size / 2);
-    this->top_bound    = 0 + (this->tile_size / 2);
-    this->bottom_bound = -(this->tile_size * this->height) + (this->tile_size / 2);
 }
 
 void Map::render(ShaderProgram *program)
 {
-    glm::mat4 model_matrix = glm::mat4(1.0f);
-    program->SetModelMatrix(model_matrix);
+    TilemapRenderer &tilemap_renderer = Utility::get_tilemap_renderer();
     
-    glUseProgram(program->programID);
+    if (this->render_mode == INDEXED_MAP_RENDER && tilemap_renderer.is_loaded())
+    {
+        tilemap_renderer.submit(this, &Utility::get_render_queue());
+        return;
+    }
     
-    glVertexAttribPointer(program->positionAttribute, 2, GL_FLOAT, false, 0, this->vertices.data());
-    glEnableVertexAttribArray(program->positionAttribute);
-    glVertexAttribPointer(program->texCoordAttribute, 2, GL_FLOAT, false, 0, this->texture_coordinates.data());
-    glEnableVertexAttribArray(program->texCoordAttribute);
+    // Whatever geometry the fallbacks need is built the first time they come up
+    if (tilemap_renderer.is_run_shader_loaded())
+    {
+        if (this->run_buffer == 0) this->build_runs();
+        tilemap_renderer.submit_runs(this, &Utility::get_render_queue());
+        return;
+    }
     
-    glBindTexture(GL_TEXTURE_2D, this->texture_id);
+    if (this->vertices.empty()) this->build_vertices();
     
-    glDrawArrays(GL_TRIANGLES, 0, (int) this->vertices.size() / 2);
-    glDisableVertexAttribArray(program->positionAttribute);
-    glDisableVertexAttribArray(program->texCoordAttribute);
+    int vertex_count = (int) this->vertices.size() / 2;
+    float *out = Utility::get_render_queue().submit(MAP_LAYER, program, this->texture_id, 0, vertex_count);
+    
+    // Already in world space; just interleaved for the queue
+    for (int i = 0; i < vertex_count; i++)
+    {
+        out[i * 4]     = this->vertices[i * 2];
+        out[i * 4 + 1] = this->vertices[i * 2 + 1];
+        out[i * 4 + 2] = this->texture_coordinates[i * 2];
+        out[i * 4 + 3] = this->texture_coordinates[i * 2 + 1];
+    }
 }
 
 bool Map::is_solid(glm::vec3 position, float *penetration_x, float *penetration_y)
@@ -92,8 +349,7 @@ bool Map::is_solid(glm::vec3 position, float *penetration_x, float *penetration_
     if (tile_x < 0 || tile_x >= this->width) return false;
     if (tile_y < 0 || tile_y >= this->height) return false;
     
-    int tile = level_data[tile_y * this->width + tile_x];
-    if (tile <= 0) return false;
+    if (!this->is_solid_slot(tile_y * this->width + tile_x)) return false;
     
     float tile_center_x = (tile_x * this->tile_size);
     float tile_center_y = -(tile_y * this->tile_size);
@@ -103,3 +359,24 @@ bool Map::is_solid(glm::vec3 position, float *penetration_x, float *penetration_
     
     return true;
 }
+
+bool const Map::get_tile_coordinates(glm::vec3 position, int *tile_x, int *tile_y) const
+{
+    *tile_x = floor((position.x + (this->tile_size / 2)) / this->tile_size);
+    *tile_y = floor((-position.y + (this->tile_size / 2)) / this->tile_size); // Our array counts up as Y goes down.
+    
+    return *tile_x >= 0 && *tile_x < this->width && *tile_y >= 0 && *tile_y < this->height;
+}
+
+bool const Map::is_solid_tile(int tile_x, int tile_y) const
+{
+    if (tile_x < 0 || tile_x >= this->width)  return true;
+    if (tile_y < 0 || tile_y >= this->height) return true;
+    
+    return this->is_solid_slot(tile_y * this->width + tile_x);
+}
+
+glm::vec3 const Map::get_tile_center(int tile_x, int tile_y) const
+{
+    return glm::vec3(tile_x * this->tile_size, -(tile_y * this->tile_size), 0.0f);
+}
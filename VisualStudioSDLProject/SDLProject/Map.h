@@ -4,6 +4,7 @@
 #include <GL/glew.h>
 #endif
 #define GL_GLEXT_PROTOTYPES 1
+#include <stdint.h>
 #include <vector>
 #include <math.h>
 #include <SDL.h>
@@ -13,37 +14,127 @@
 #include "glm/gtc/matrix_transform.hpp"
 #include "ShaderProgram.h"
 
+// Indexed maps upload one texel per tile and are drawn by the TilemapRenderer as a single quad.
+// Quad maps merge runs of the same tile into one quad each, and are what indexed maps fall back to
+// without the tilemap shader; without the run shader as well, every tile gets its own six vertices
+enum MapRenderMode { QUAD_MAP_RENDER, INDEXED_MAP_RENDER };
+
+// Decoration around the collision layer; backgrounds go under the sprites, foregrounds over them
+enum MapLayerKind { BACKGROUND_TILES, FOREGROUND_TILES };
+
+#define DEFAULT_MAP_RENDER_MODE INDEXED_MAP_RENDER
+#define RUN_FLOATS_PER_VERTEX 6 // x, y, then u, v inside the run in tiles, then the run's tileset cell
+#define MAP_MAX_LAYERS 8        // all kinds together, collision included; fragment_tilemap.glsl has the same
+#define MAP_NO_TILE 0xFFFF      // an empty spot on a decoration layer
+#define MAP_VERTEX_REPORT 0     // 1 prints tile vs merged-run vertex counts for every map built
+
+// A level the compiler has already built (see StaticLevel.h), reduced to plain pointers
+struct StaticLevelData
+{
+    int width;
+    int height;
+    int tile_count_x;
+    const unsigned int  *tiles;
+    const unsigned char *texels;       // the index texture, ready to upload
+    const float         *run_vertices; // merged runs for a tile size of 1
+    int                  run_vertex_count;
+    const uint32_t      *solid_bits;
+};
+
+struct MapTileLayer
+{
+    std::vector<unsigned int> tiles;
+    float parallax; // how far it scrolls per unit the camera moves; 1 moves with the collision layer
+};
+
 class Map {
 private:
     int width;
     int height;
     
+    std::vector<unsigned int> tiles; // the map's own copy, so edits never reach the scene's level array
     unsigned int *level_data;
+    
+    std::vector<uint32_t> solid_bits; // one bit per tile of level_data, set where it's solid
+    
+    // Compile-time geometry for built-in levels, until the first edit makes it stale; tiles is
+    // null for maps built from runtime arrays
+    StaticLevelData prebuilt = {};
+    
+    // Only drawn; is_solid and everything else only ever sees level_data
+    std::vector<MapTileLayer> background_layers;
+    std::vector<MapTileLayer> foreground_layers;
     GLuint texture_id;
     
     float tile_size;
     int tile_count_x;
     int tile_count_y;
     
+    MapRenderMode render_mode;
+    
     std::vector<float> vertices;
     std::vector<float> texture_coordinates;
+    GLuint index_texture_id = 0;
+    GLuint run_buffer = 0;
+    int run_vertex_count = 0;
+    bool run_slots = false;  // runs split back into one slot per tile, at y * width + x, once edited
+    unsigned int revision = 0;
     
     float left_bound, right_bound, top_bound, bottom_bound;
     
+    void initialise(int width, int height, const unsigned int *level_data, GLuint texture_id, float tile_size,
+                    int tile_count_x, int tile_count_y, MapRenderMode render_mode);
+    void build_solid_bits();
+    void build_vertices();
+    void build_runs();
+    void build_run_slots();
+    void build_index_texture();
+    int const merge_runs(std::vector<float> *run_vertices) const;
+    bool const is_solid_slot(int slot) const { return (this->solid_bits[slot / 32] >> (slot % 32)) & 1; }
+    
 public:
-    Map(int width, int height, unsigned int *level_data, GLuint texture_id, float tile_size, int
-    tile_count_x, int tile_count_y);
+    Map(int width, int height, const unsigned int *level_data, GLuint texture_id, float tile_size, int
+    tile_count_x, int tile_count_y, MapRenderMode render_mode = DEFAULT_MAP_RENDER_MODE);
+    Map(const StaticLevelData &level, GLuint texture_id, float tile_size, int tile_count_y,
+        MapRenderMode render_mode = DEFAULT_MAP_RENDER_MODE);
+    ~Map();
     
     void build();
     void render(ShaderProgram *program);
     bool is_solid(glm::vec3 position, float *penetration_x, float *penetration_y);
     
+    // Changes one tile for collision and drawing alike, patching only that tile's GPU data.
+    // False if the tile is off the map
+    bool set_tile(int tile_x, int tile_y, unsigned int tile);
+    
+    // Same size as the map, drawn in the order added within each kind. Only indexed maps drawn by the
+    // tilemap shader show them; the quad fallbacks draw the collision layer alone. False once full
+    bool add_layer(MapLayerKind kind, const unsigned int *layer_data, float parallax);
+    
+    // Layers are numbered back to front: backgrounds, then collision, then foregrounds
+    int const get_layer_count()     const { return (int) (this->background_layers.size() + 1 + this->foreground_layers.size()); }
+    int const get_collision_layer() const { return (int) this->background_layers.size(); }
+    const unsigned int * const get_layer_data(int layer) const;
+    float const get_layer_parallax(int layer) const;
+    
+    // Tile-space helpers
+    bool const get_tile_coordinates(glm::vec3 position, int *tile_x, int *tile_y) const;
+    bool const is_solid_tile(int tile_x, int tile_y) const;
+    glm::vec3 const get_tile_center(int tile_x, int tile_y) const;
+    
     // Getters
     int const get_width()  const  { return this->width;  }
     int const get_height() const  { return this->height; }
     
     unsigned int* const get_level_data() const { return this->level_data; }
     GLuint        const get_texture_id() const { return this->texture_id; }
+    GLuint        const get_index_texture_id() const { return this->index_texture_id; }
+    MapRenderMode const get_render_mode()      const { return this->render_mode;      }
+    GLuint        const get_run_buffer()       const { return this->run_buffer;       }
+    int           const get_run_vertex_count() const { return this->run_vertex_count; }
+    
+    // Goes up with every set_tile, so anything caching the layout knows to look again
+    unsigned int const get_revision() const { return this->revision; }
     
     float const get_tile_size() const { return this->tile_size; }
     int const get_tile_count_x() const { return this->tile_count_x; }
@@ -0,0 +1,165 @@
+#include <algorithm>
+#include "Pathfinder.h"
+
+static const int NEIGHBOUR_X[] = { -1, 1,  0, 0 };
+static const int NEIGHBOUR_Y[] = {  0, 0, -1, 1 };
+
+static bool open_node_greater(const OpenNode &a, const OpenNode &b) { return a.f_cost > b.f_cost; }
+
+void Pathfinder::build(Map *map)
+{
+    this->map    = map;
+    this->width  = map->get_width();
+    this->height = map->get_height();
+
+    int tile_count = this->width * this->height;
+
+    this->distance.assign(tile_count, -1);
+    this->next_tile.assign(tile_count, -1);
+    this->frontier.reserve(tile_count);
+    this->target_tile = -1;
+    this->map_revision = map->get_revision();
+
+    this->g_cost.assign(tile_count, 0.0f);
+    this->parent.assign(tile_count, -1);
+    this->visited.assign(tile_count, 0);
+    this->closed.assign(tile_count, 0);
+    this->open_list.reserve(tile_count);
+    this->search_stamp = 0;
+}
+
+int const Pathfinder::tile_index(glm::vec3 position) const
+{
+    int tile_x, tile_y;
+    if (!this->map->get_tile_coordinates(position, &tile_x, &tile_y)) return -1;
+
+    return tile_y * this->width + tile_x;
+}
+
+void Pathfinder::update_flow_field(glm::vec3 target)
+{
+    // Nothing changes until the target crosses into another tile or a tile of the map is edited
+    int new_target = this->tile_index(target);
+    if (new_target == this->target_tile && this->map->get_revision() == this->map_revision) return;
+
+    this->target_tile  = new_target;
+    this->map_revision = this->map->get_revision();
+    this->rebuild_flow_field();
+}
+
+void Pathfinder::rebuild_flow_field()
+{
+    std::fill(this->distance.begin(), this->distance.end(), -1);
+    std::fill(this->next_tile.begin(), this->next_tile.end(), -1);
+
+    if (this->target_tile < 0) return;
+
+    // Breadth-first out from the target; every tile reached points back at the tile it was reached from
+    this->frontier.clear();
+    this->frontier.push_back(this->target_tile);
+    this->distance[this->target_tile] = 0;
+
+    for (size_t head = 0; head < this->frontier.size(); head++)
+    {
+        int tile   = this->frontier[head];
+        int tile_x = tile % this->width;
+        int tile_y = tile / this->width;
+
+        for (int n = 0; n < 4; n++)
+        {
+            int neighbour_x = tile_x + NEIGHBOUR_X[n];
+            int neighbour_y = tile_y + NEIGHBOUR_Y[n];
+            if (this->map->is_solid_tile(neighbour_x, neighbour_y)) continue;
+
+            int neighbour = neighbour_y * this->width + neighbour_x;
+            if (this->distance[neighbour] >= 0) continue;
+
+            this->distance[neighbour]  = this->distance[tile] + 1;
+            this->next_tile[neighbour] = tile;
+            this->frontier.push_back(neighbour);
+        }
+    }
+}
+
+glm::vec3 const Pathfinder::get_flow_direction(glm::vec3 position) const
+{
+    int tile = this->tile_index(position);
+    if (tile < 0 || this->next_tile[tile] < 0) return glm::vec3(0.0f);
+
+    // Steer for the centre of the next tile rather than along the grid axis so wide sprites don't catch on corners
+    int next = this->next_tile[tile];
+    glm::vec3 offset = this->map->get_tile_center(next % this->width, next / this->width) - position;
+    offset.z = 0.0f;
+
+    if (glm::length(offset) == 0.0f) return glm::vec3(0.0f);
+    return glm::normalize(offset);
+}
+
+bool Pathfinder::find_path(glm::vec3 start, glm::vec3 goal, std::vector<glm::vec3> &path)
+{
+    path.clear();
+
+    int start_tile = this->tile_index(start);
+    int goal_tile  = this->tile_index(goal);
+    if (start_tile < 0 || goal_tile < 0) return false;
+
+    int goal_x = goal_tile % this->width;
+    int goal_y = goal_tile / this->width;
+
+    // A fresh stamp invalidates the previous search without touching the arrays
+    this->search_stamp++;
+    this->open_list.clear();
+
+    this->g_cost[start_tile]  = 0.0f;
+    this->parent[start_tile]  = -1;
+    this->visited[start_tile] = this->search_stamp;
+
+    OpenNode start_node = { (float) (abs(start_tile % this->width - goal_x) + abs(start_tile / this->width - goal_y)), start_tile };
+    this->open_list.push_back(start_node);
+
+    while (!this->open_list.empty())
+    {
+        std::pop_heap(this->open_list.begin(), this->open_list.end(), open_node_greater);
+        OpenNode current = this->open_list.back();
+        this->open_list.pop_back();
+
+        if (this->closed[current.tile] == this->search_stamp) continue;
+        this->closed[current.tile] = this->search_stamp;
+
+        if (current.tile == goal_tile)
+        {
+            for (int tile = goal_tile; tile >= 0; tile = this->parent[tile])
+            {
+                path.push_back(this->map->get_tile_center(tile % this->width, tile / this->width));
+            }
+            std::reverse(path.begin(), path.end());
+            return true;
+        }
+
+        int tile_x = current.tile % this->width;
+        int tile_y = current.tile / this->width;
+
+        for (int n = 0; n < 4; n++)
+        {
+            int neighbour_x = tile_x + NEIGHBOUR_X[n];
+            int neighbour_y = tile_y + NEIGHBOUR_Y[n];
+            if (this->map->is_solid_tile(neighbour_x, neighbour_y)) continue;
+
+            int neighbour = neighbour_y * this->width + neighbour_x;
+            if (this->closed[neighbour] == this->search_stamp) continue;
+
+            float new_cost = this->g_cost[current.tile] + 1.0f;
+            if (this->visited[neighbour] == this->search_stamp && new_cost >= this->g_cost[neighbour]) continue;
+
+            this->visited[neighbour] = this->search_stamp;
+            this->g_cost[neighbour]  = new_cost;
+            this->parent[neighbour]  = current.tile;
+
+            OpenNode node = { new_cost + (float) (abs(neighbour_x - goal_x) + abs(neighbour_y - goal_y)), neighbour };
+            this->open_list.push_back(node);
+            std::push_heap(this->open_list.begin(), this->open_list.end(), open_node_greater);
+        }
+    }
+
+    return false;
+}
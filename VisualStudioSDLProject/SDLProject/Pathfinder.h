@@ -0,0 +1,47 @@
+#pragma once
+#include <vector>
+#include "Map.h"
+
+struct OpenNode
+{
+    float f_cost;
+    int tile;
+};
+
+class Pathfinder {
+private:
+    Map *map = NULL;
+    int width  = 0;
+    int height = 0;
+
+    // Flow field toward the current target, shared by every chasing entity. Rebuilt in full, one
+    // breadth-first pass over the map, whenever the target changes tile or the map is edited
+    std::vector<int> distance;  // steps to the target tile, -1 if unreachable
+    std::vector<int> next_tile; // neighbour one step closer to the target, -1 at the target itself
+    std::vector<int> frontier;
+    int target_tile = -1;
+    unsigned int map_revision = 0; // the map's layout the flow field was built against
+
+    // A* arena; sized once in build() and reused by every search
+    std::vector<float>    g_cost;
+    std::vector<int>      parent;
+    std::vector<unsigned> visited; // search stamp the tile was last touched by
+    std::vector<unsigned> closed;
+    std::vector<OpenNode> open_list;
+    unsigned search_stamp = 0;
+
+    int const tile_index(glm::vec3 position) const;
+    void rebuild_flow_field();
+
+public:
+    void build(Map *map);
+
+    void update_flow_field(glm::vec3 target);
+    glm::vec3 const get_flow_direction(glm::vec3 position) const;
+
+    // One-off routes to somewhere other than the flow field's target, as tile centres from start to
+    // goal. Shares one arena between searches, so call it from the scene, not from AI behaviours
+    bool find_path(glm::vec3 start, glm::vec3 goal, std::vector<glm::vec3> &path);
+
+    int const get_target_tile() const { return this->target_tile; }
+};
@@ -0,0 +1,262 @@
+#include "RenderQueue.h"
+
+int RenderQueue::shader_index(ShaderProgram *program)
+{
+    for (size_t i = 0; i < this->programs.size(); i++)
+    {
+        if (this->programs[i] == program) return (int) i;
+    }
+
+    this->programs.push_back(program);
+    return (int) this->programs.size() - 1;
+}
+
+uint64_t RenderQueue::make_key(RenderLayer layer, ShaderProgram *program, GLuint texture_id, int depth)
+{
+    // Texture ids only group draws; two textures sharing low bits still draw with their own texture
+    if (layer != MAP_LAYER)
+    {
+        // Blended: what's on top is decided by depth and the order things were submitted in
+        return ((uint64_t) (layer & 0xFF)                       << 56) |
+               ((uint64_t) (depth & 0xFFFF)                     << 40) |
+               ((uint64_t) (this->commands.size() & 0xFFFF)     << 24) |
+               ((uint64_t) (this->shader_index(program) & 0xFF) << 16) |
+               ((uint64_t) (texture_id & 0xFFFF));
+    }
+
+    return ((uint64_t) (layer & 0xFF)                       << 56) |
+           ((uint64_t) (this->shader_index(program) & 0xFF) << 48) |
+           ((uint64_t) (texture_id & 0xFFFF)                << 32) |
+           ((uint64_t) (depth & 0xFFFF)                     << 16) |
+           ((uint64_t) (this->commands.size() & 0xFFFF));
+}
+
+float *RenderQueue::submit(RenderLayer layer, ShaderProgram *program, GLuint texture_id, int depth, int vertex_count)
+{
+    RenderCommand command;
+    command.key        = this->make_key(layer, program, texture_id, depth);
+    command.program    = program;
+    command.texture_id = texture_id;
+    command.buffer     = 0;
+    command.first      = (int) this->staging.size() / RENDER_FLOATS_PER_VERTEX;
+    command.count      = vertex_count;
+    command.offset     = glm::vec3(0.0f);
+    command.callback   = NULL;
+    command.data       = NULL;
+
+    this->commands.push_back(command);
+    this->staging.resize(this->staging.size() + vertex_count * RENDER_FLOATS_PER_VERTEX);
+
+    return &this->staging[command.first * RENDER_FLOATS_PER_VERTEX];
+}
+
+void RenderQueue::submit_buffer(RenderLayer layer, ShaderProgram *program, GLuint texture_id, int depth,
+                                GLuint buffer, int vertex_count, glm::vec3 offset)
+{
+    RenderCommand command;
+    command.key        = this->make_key(layer, program, texture_id, depth);
+    command.program    = program;
+    command.texture_id = texture_id;
+    command.buffer     = buffer;
+    command.first      = 0;
+    command.count      = vertex_count;
+    command.offset     = offset;
+    command.callback   = NULL;
+    command.data       = NULL;
+
+    this->commands.push_back(command);
+}
+
+void RenderQueue::submit_callback(RenderLayer layer, ShaderProgram *program, GLuint texture_id, int depth,
+                                  RenderCallback callback, void *data)
+{
+    RenderCommand command;
+    command.key        = this->make_key(layer, program, texture_id, depth);
+    command.program    = program;
+    command.texture_id = texture_id;
+    command.buffer     = 0;
+    command.first      = 0;
+    command.count      = 0;
+    command.offset     = glm::vec3(0.0f);
+    command.callback   = callback;
+    command.data       = data;
+
+    this->commands.push_back(command);
+}
+
+void RenderQueue::sort()
+{
+    int count = (int) this->commands.size();
+
+    this->keys.resize(count);
+    this->order.resize(count);
+    this->scratch_keys.resize(count);
+    this->scratch_order.resize(count);
+
+    for (int i = 0; i < count; i++)
+    {
+        this->keys[i]  = this->commands[i].key;
+        this->order[i] = i;
+    }
+
+    // Least significant digit first; each pass is stable, so earlier passes survive later ones
+    const int buckets = 1 << RENDER_RADIX_BITS;
+    int offsets[buckets];
+
+    for (int shift = 0; shift < 64; shift += RENDER_RADIX_BITS)
+    {
+        for (int i = 0; i < buckets; i++) offsets[i] = 0;
+        for (int i = 0; i < count; i++) offsets[(this->keys[i] >> shift) & (buckets - 1)]++;
+
+        // Every key has the same digit here (most of the layer and shader bits, usually): nothing moves
+        if (offsets[(this->keys[0] >> shift) & (buckets - 1)] == count) continue;
+
+        int total = 0;
+        for (int i = 0; i < buckets; i++)
+        {
+            int bucket_size = offsets[i];
+            offsets[i] = total;
+            total += bucket_size;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            int slot = offsets[(this->keys[i] >> shift) & (buckets - 1)]++;
+            this->scratch_keys[slot]  = this->keys[i];
+            this->scratch_order[slot] = this->order[i];
+        }
+
+        this->keys.swap(this->scratch_keys);
+        this->order.swap(this->scratch_order);
+    }
+}
+
+void RenderQueue::batch()
+{
+    this->stream.clear();
+    this->draws.clear();
+
+    for (size_t i = 0; i < this->order.size(); i++)
+    {
+        RenderCommand command = this->commands[this->order[i]];
+
+        if (command.buffer != 0 || command.callback != NULL)
+        {
+            this->draws.push_back(command);
+            continue;
+        }
+
+        // Copy streamed vertices out in draw order, so same-state neighbours end up back to back
+        int first = (int) this->stream.size() / RENDER_FLOATS_PER_VERTEX;
+        const float *source = &this->staging[command.first * RENDER_FLOATS_PER_VERTEX];
+        this->stream.insert(this->stream.end(), source, source + command.count * RENDER_FLOATS_PER_VERTEX);
+        command.first = first;
+
+        if (!this->draws.empty())
+        {
+            RenderCommand &previous = this->draws.back();
+            if (previous.buffer == 0 && previous.callback == NULL && previous.program == command.program && previous.texture_id == command.texture_id)
+            {
+                previous.count += command.count;
+                continue;
+            }
+        }
+
+        this->draws.push_back(command);
+    }
+}
+
+void RenderQueue::execute()
+{
+    this->draw_count = 0;
+    if (this->commands.empty()) return;
+
+    this->sort();
+    this->batch();
+
+    if (!this->stream.empty())
+    {
+        if (this->stream_buffer == 0) glGenBuffers(1, &this->stream_buffer);
+
+        glBindBuffer(GL_ARRAY_BUFFER, this->stream_buffer);
+        glBufferData(GL_ARRAY_BUFFER, this->stream.size() * sizeof(float), this->stream.data(), GL_STREAM_DRAW);
+    }
+
+    // Only what differs from the previous draw is sent to GL
+    const RenderCommand *previous = NULL;
+
+    for (size_t i = 0; i < this->draws.size(); i++)
+    {
+        const RenderCommand &draw = this->draws[i];
+        ShaderProgram *program = draw.program;
+
+        if (draw.callback != NULL)
+        {
+            if (previous != NULL)
+            {
+                glDisableVertexAttribArray(previous->program->positionAttribute);
+                glDisableVertexAttribArray(previous->program->texCoordAttribute);
+            }
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+            draw.callback(draw.data);
+            this->draw_count++;
+
+            // No telling what it left bound, so the next draw sets everything again. The submitted
+            // program is made current, as callers expect it to be once the queue has run
+            glUseProgram(program->programID);
+            previous = NULL;
+            continue;
+        }
+
+        bool new_program = previous == NULL || previous->program != program;
+        if (new_program && previous != NULL)
+        {
+            glDisableVertexAttribArray(previous->program->positionAttribute);
+            glDisableVertexAttribArray(previous->program->texCoordAttribute);
+        }
+        if (new_program) glUseProgram(program->programID);
+
+        if (new_program || previous->offset != draw.offset)
+        {
+            program->SetModelMatrix(glm::translate(glm::mat4(1.0f), draw.offset));
+        }
+
+        if (previous == NULL || previous->texture_id != draw.texture_id) glBindTexture(GL_TEXTURE_2D, draw.texture_id);
+
+        if (new_program || previous->buffer != draw.buffer)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, draw.buffer != 0 ? draw.buffer : this->stream_buffer);
+
+            glVertexAttribPointer(program->positionAttribute, 2, GL_FLOAT, false, RENDER_FLOATS_PER_VERTEX * sizeof(float), (void*) 0);
+            glEnableVertexAttribArray(program->positionAttribute);
+            glVertexAttribPointer(program->texCoordAttribute, 2, GL_FLOAT, false, RENDER_FLOATS_PER_VERTEX * sizeof(float), (void*) (2 * sizeof(float)));
+            glEnableVertexAttribArray(program->texCoordAttribute);
+        }
+
+        glDrawArrays(GL_TRIANGLES, draw.first, draw.count);
+        this->draw_count++;
+
+        previous = &draw;
+    }
+
+    if (previous != NULL)
+    {
+        glDisableVertexAttribArray(previous->program->positionAttribute);
+        glDisableVertexAttribArray(previous->program->texCoordAttribute);
+    }
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    this->commands.clear();
+    this->staging.clear();
+}
+
+void RenderQueue::release()
+{
+    if (this->stream_buffer != 0) glDeleteBuffers(1, &this->stream_buffer);
+    this->stream_buffer = 0;
+
+    this->commands.clear();
+    this->staging.clear();
+    this->programs.clear();
+}
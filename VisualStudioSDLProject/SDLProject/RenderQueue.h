@@ -0,0 +1,97 @@
+#pragma once
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <stdint.h>
+#include <vector>
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "ShaderProgram.h"
+
+#define RENDER_FLOATS_PER_VERTEX 4 // x, y, u, v
+#define RENDER_RADIX_BITS 8
+
+// Drawn bottom to top; nothing in a higher layer can end up under a lower one
+enum RenderLayer { MAP_LAYER, SPRITE_LAYER, FOREGROUND_LAYER, TEXT_LAYER };
+
+// Draws something the queue can't describe itself (extra textures or uniforms) with its own GL calls
+typedef void (*RenderCallback)(void *data);
+
+/**
+ One draw, as submitted. Vertices either sit in the queue's own per-frame stream (buffer == 0) or in
+ a buffer object the caller keeps, drawn at offset. Commands with a callback draw themselves.
+ */
+struct RenderCommand
+{
+    uint64_t key;
+    ShaderProgram *program;
+    GLuint texture_id;
+    GLuint buffer;
+    int first;
+    int count;
+    glm::vec3 offset;
+    RenderCallback callback;
+    void *data;
+};
+
+/**
+ Everything drawn in a frame is submitted here first and only goes to GL in execute(). Commands are
+ sorted on one packed key, from the top bits down. The map layer's tiles never overlap one another,
+ so it is grouped by state:
+
+     layer (8) | shader (8) | texture (16) | depth (16) | submission order (16)
+
+ The other layers are alpha blended and their sprites and text do overlap, so they keep the scene's
+ order, and shader and texture only break ties that can't happen:
+
+     layer (8) | depth (16) | submission order (16) | shader (8) | texture (16)
+
+ Streamed commands that end up next to each other with the same state are merged into a single draw
+ call; in the blended layers that means only ones submitted back to back.
+ */
+class RenderQueue {
+private:
+    std::vector<ShaderProgram*> programs; // the shader field of the key indexes into this
+    std::vector<RenderCommand> commands;
+    std::vector<float> staging;           // streamed vertices, in submission order
+
+    // Rebuilt every execute()
+    std::vector<uint64_t> keys, scratch_keys;
+    std::vector<int> order, scratch_order;
+    std::vector<float> stream;            // staging rearranged into draw order
+    std::vector<RenderCommand> draws;
+    GLuint stream_buffer = 0;
+
+    int draw_count = 0;
+
+    int shader_index(ShaderProgram *program);
+    uint64_t make_key(RenderLayer layer, ShaderProgram *program, GLuint texture_id, int depth);
+    void sort();
+    void batch();
+
+public:
+    // Space for vertex_count streamed vertices (x, y, u, v in world space) to be filled in by the
+    // caller. Higher depths draw over lower ones in the same layer, equal depths in submission order.
+    // The pointer is only good until the next submit
+    float *submit(RenderLayer layer, ShaderProgram *program, GLuint texture_id, int depth, int vertex_count);
+
+    // Vertices already in a buffer object (same layout), drawn translated by offset
+    void submit_buffer(RenderLayer layer, ShaderProgram *program, GLuint texture_id, int depth,
+                       GLuint buffer, int vertex_count, glm::vec3 offset);
+
+    // Sorted like any other command; data has to stay valid until execute()
+    void submit_callback(RenderLayer layer, ShaderProgram *program, GLuint texture_id, int depth,
+                         RenderCallback callback, void *data);
+
+    void execute();
+    void release();
+
+    int const get_command_count() const { return (int) this->commands.size(); }
+    int const get_draw_count()    const { return this->draw_count; } // draw calls in the last execute()
+};
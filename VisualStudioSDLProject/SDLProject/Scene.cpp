@@ -1 +1,104 @@
 #include "Scene.h"
+#include "JobGraph.h"
+#include <algorithm>
+
+#define JOB_MIN_ENTITIES 256 // below this, spreading a step over threads costs more than it saves
+#define JOB_GRAIN 64         // entities per job
+
+// One set of worker threads for every scene, started the first time a scene is busy enough to need it.
+// One per core, short of the event bus's limit (its first queue is for the thread running the step)
+static WorkStealingPool &job_pool()
+{
+    static WorkStealingPool pool(std::min((int) std::thread::hardware_concurrency(), EVENT_MAX_THREADS - 1));
+    return pool;
+}
+
+GLuint Scene::load_texture(const char *filepath)
+{
+    GLuint texture_id = Utility::load_texture(filepath);
+    this->state.arena.create<OwnedTexture>(texture_id);
+    return texture_id;
+}
+
+Mix_Music *Scene::load_music(const char *filepath)
+{
+    Mix_Music *music = Mix_LoadMUS(filepath);
+    this->state.arena.create<OwnedMusic>(music);
+    return music;
+}
+
+Mix_Chunk *Scene::load_chunk(const char *filepath)
+{
+    Mix_Chunk *chunk = Mix_LoadWAV(filepath);
+    this->state.arena.create<OwnedChunk>(chunk);
+    return chunk;
+}
+
+void Scene::release()
+{
+    this->state.arena.reset();
+    
+    // Nothing the systems or pointers below refer to survives the reset
+    this->state.map      = NULL;
+    this->state.player   = NULL;
+    this->state.enemies  = NULL;
+    this->state.npc      = NULL;
+    this->state.bgm      = NULL;
+    this->state.jump_sfx = NULL;
+    
+    this->state.animations.clear();
+    this->state.ai.clear();
+    this->state.visibility.clear();
+    this->state.events.clear();
+    this->state.step_graph.clear();
+}
+
+void Scene::update_entities(float delta_time, int enemy_count)
+{
+    Entity *player = this->state.player;
+    Entity *enemies = this->state.enemies;
+    Map *map = this->state.map;
+    
+    this->state.paths.update_flow_field(player->get_position());
+    
+    if (enemy_count < JOB_MIN_ENTITIES)
+    {
+        this->state.ai.update(player);
+        player->update(delta_time, player, enemies, enemy_count, map);
+        for (int i = 0; i < enemy_count; i++) enemies[i].update(delta_time, player, NULL, 0, map);
+        this->state.animations.advance(delta_time);
+        this->state.events.resolve();
+        return;
+    }
+    
+    // Same phases in the same order as above; only the work inside a phase is split up. Every job
+    // writes to its own entities, so the result doesn't depend on how the jobs get scheduled.
+    AISystem &ai = this->state.ai;
+    AnimationSystem &animations = this->state.animations;
+    JobGraph &graph = this->state.step_graph;
+    graph.clear();
+    
+    ai.prepare(player);
+    
+    int thinking = graph.add_range(ai.get_thinking_count(), JOB_GRAIN, [&ai, player](int begin, int end) {
+        ai.think(player, begin, end);
+    }, -1);
+    
+    // The player pushes into enemies, so it has to finish before they move
+    int player_step = graph.add([=] { player->update(delta_time, player, enemies, enemy_count, map); });
+    graph.add_dependency(player_step, thinking);
+    
+    int movement = graph.add_range(enemy_count, JOB_GRAIN, [=](int begin, int end) {
+        for (int i = begin; i < end; i++) enemies[i].update(delta_time, player, NULL, 0, map);
+    }, player_step);
+    
+    graph.add_range(animations.get_count(), JOB_GRAIN, [&animations, delta_time](int begin, int end) {
+        animations.advance_range(delta_time, begin, end);
+    }, movement);
+    
+    this->state.events.set_pool(&job_pool());
+    graph.run(job_pool());
+    
+    // Hits and dialogue from every job land together, in serial order
+    this->state.events.resolve();
+}
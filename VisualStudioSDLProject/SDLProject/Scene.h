@@ -15,16 +15,59 @@
 #include "Utility.h"
 #include "Entity.h"
 #include "Map.h"
+#include "AnimationSystem.h"
+#include "AISystem.h"
+#include "VisibilitySystem.h"
+#include "Pathfinder.h"
+#include "SceneArena.h"
+#include "JobGraph.h"
+#include "Camera.h"
+
+/**
+ Textures and audio a scene loads in initialise(). They're created in the scene's arena, so the same
+ reset() that tears down the map and entities releases them too.
+ */
+struct OwnedTexture
+{
+    GLuint id;
+    OwnedTexture(GLuint id) : id(id) {}
+    ~OwnedTexture() { glDeleteTextures(1, &this->id); }
+};
+
+struct OwnedMusic
+{
+    Mix_Music *music;
+    OwnedMusic(Mix_Music *music) : music(music) {}
+    ~OwnedMusic() { Mix_FreeMusic(this->music); }
+};
+
+struct OwnedChunk
+{
+    Mix_Chunk *chunk;
+    OwnedChunk(Mix_Chunk *chunk) : chunk(chunk) {}
+    ~OwnedChunk() { Mix_FreeChunk(this->chunk); }
+};
 
 struct GameState
 {
+    SceneArena arena; // owns the map, entities, frame tables, textures and audio below
+    
     Map *map;
     Entity *player;
     Entity *enemies;
     Entity* npc = NULL;
     
-    Mix_Music *bgm;
-    Mix_Chunk *jump_sfx;
+    AnimationSystem animations;
+    AISystem ai;
+    Pathfinder paths;
+    VisibilitySystem visibility; // enemies only; the camera follows the player, so it is always on screen
+    EventBus events;
+    JobGraph step_graph; // rebuilt each step by Scene::update_entities when there are enough entities
+    
+    Camera *camera = NULL; // set by whoever drives the scene; its visible rect is what's on screen
+    
+    Mix_Music *bgm = NULL;
+    Mix_Chunk *jump_sfx = NULL;
 };
 
 class Scene {
@@ -35,13 +78,30 @@ public:
     bool cutscene = false;
     bool completed = false; // flag to show level has completed, immediately switch to next
     
+    // Idle scenes (title and dialogue screens) have nothing moving on their own, so the loop only
+    // redraws them when dirty and otherwise sleeps until input arrives
+    bool idle = false;
+    bool dirty = true;
+    
     int decision; // ADDITION: better way to do this
 
     GameState state;
     
+    // Loaded through the scene so the arena frees them on the next reset()
+    GLuint load_texture(const char *filepath);
+    Mix_Music *load_music(const char *filepath);
+    Mix_Chunk *load_chunk(const char *filepath);
+    
+    // Hands back everything initialise() built, in one arena reset; needs the GL context current
+    void release();
+    
     virtual void initialise() = 0;
     virtual void update(float delta_time) = 0;
     virtual void render(ShaderProgram *program) = 0;
     
-    GameState const get_state() const { return this->state; }
+    // Flow field, AI, player, enemies and animation for one step, spread over worker threads once
+    // there are enough enemies to be worth it
+    void update_entities(float delta_time, int enemy_count);
+    
+    GameState const &get_state() const { return this->state; }
 };
@@ -0,0 +1,69 @@
+#include "SceneArena.h"
+
+SceneArena::~SceneArena()
+{
+    this->reset();
+    for (size_t i = 0; i < this->blocks.size(); i++) delete [] this->blocks[i].memory;
+}
+
+void *SceneArena::allocate(size_t size, size_t alignment)
+{
+    while (true)
+    {
+        if (this->current_block < this->blocks.size())
+        {
+            Block &block = this->blocks[this->current_block];
+
+            size_t start = (block.used + alignment - 1) & ~(alignment - 1);
+            if (start + size <= block.size)
+            {
+                this->bytes_used += (start + size) - block.used;
+                if (this->bytes_used > this->high_water_mark) this->high_water_mark = this->bytes_used;
+
+                block.used = start + size;
+                return block.memory + start;
+            }
+
+            // Blocks kept from an earlier visit are reused before anything new is allocated
+            if (this->current_block + 1 < this->blocks.size())
+            {
+                this->current_block++;
+                continue;
+            }
+        }
+
+        // Out of room: chain a new block big enough for this request
+        Block block;
+        block.size   = size + alignment > ARENA_BLOCK_SIZE ? size + alignment : ARENA_BLOCK_SIZE;
+        block.memory = new char[block.size];
+        block.used   = 0;
+
+        this->blocks.push_back(block);
+        this->current_block = this->blocks.size() - 1;
+    }
+}
+
+int *SceneArena::ints(std::initializer_list<int> values)
+{
+    int *array = static_cast<int*>(this->allocate(sizeof(int) * values.size(), alignof(int)));
+
+    int i = 0;
+    for (int value : values) array[i++] = value;
+
+    return array;
+}
+
+void SceneArena::reset()
+{
+    // Tear down in reverse order of creation, same as a stack of locals would
+    for (size_t i = this->destructors.size(); i > 0; i--)
+    {
+        Destructor &destructor = this->destructors[i - 1];
+        destructor.destroy(destructor.objects, destructor.count);
+    }
+    this->destructors.clear();
+
+    for (size_t i = 0; i < this->blocks.size(); i++) this->blocks[i].used = 0;
+    this->current_block = 0;
+    this->bytes_used    = 0;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <new>
+#include <vector>
+#include <cstddef>
+#include <initializer_list>
+
+#define ARENA_BLOCK_SIZE 65536 // bytes; a scene that outgrows this chains another block
+
+/**
+ Bump allocator for everything a scene creates in initialise(). Nothing is freed on its own; reset()
+ runs the destructors and rewinds the whole arena in one step. Scene::release() calls it when the
+ scene is left and at shutdown, and initialise() calls it again in case it was never left.
+ */
+class SceneArena {
+private:
+    struct Block
+    {
+        char  *memory;
+        size_t size;
+        size_t used;
+    };
+
+    struct Destructor
+    {
+        void (*destroy)(void *objects, size_t count);
+        void  *objects;
+        size_t count;
+    };
+
+    std::vector<Block>      blocks;
+    std::vector<Destructor> destructors;
+    size_t current_block = 0;
+
+    size_t bytes_used      = 0;
+    size_t high_water_mark = 0;
+
+    void *allocate(size_t size, size_t alignment);
+
+    template <typename T>
+    static void destroy_objects(void *objects, size_t count)
+    {
+        T *typed = static_cast<T*>(objects);
+        for (size_t i = count; i > 0; i--) typed[i - 1].~T();
+    }
+
+    template <typename T>
+    void track(T *objects, size_t count)
+    {
+        Destructor destructor = { destroy_objects<T>, objects, count };
+        this->destructors.push_back(destructor);
+    }
+
+public:
+    SceneArena() = default;
+    SceneArena(const SceneArena&) = delete;
+    SceneArena &operator=(const SceneArena&) = delete;
+    ~SceneArena();
+
+    template <typename T, typename... Args>
+    T *create(Args&&... args)
+    {
+        T *object = new (this->allocate(sizeof(T), alignof(T))) T(static_cast<Args&&>(args)...);
+        this->track(object, 1);
+        return object;
+    }
+
+    template <typename T>
+    T *create_array(int count)
+    {
+        T *objects = static_cast<T*>(this->allocate(sizeof(T) * count, alignof(T)));
+        for (int i = 0; i < count; i++) new (&objects[i]) T();
+        this->track(objects, count);
+        return objects;
+    }
+
+    // Animation frame tables, e.g. arena.ints({ 1, 5, 9, 13 })
+    int *ints(std::initializer_list<int> values);
+
+    void reset();
+
+    size_t const get_bytes_used()      const { return this->bytes_used;      }
+    size_t const get_high_water_mark() const { return this->high_water_mark; }
+};
@@ -0,0 +1,126 @@
+#pragma once
+#include <stdint.h>
+#include "Map.h"
+
+/**
+ Run geometry, shared by levels built at compile time and by Map at runtime so both come out the
+ same. write_tile_run puts one run's six vertices at out, positions relative to the centre of tile
+ (0, 0), u/v in tiles across the run and the tile's tileset cell.
+ */
+constexpr void write_tile_run(float *out, unsigned int tile, int x, int y, int run_width, int run_height,
+                              float tile_size, int tile_count_x)
+{
+    float left   = -(tile_size / 2) + tile_size * x;
+    float right  = left + tile_size * run_width;
+    float top    = (tile_size / 2) - tile_size * y;
+    float bottom = top - tile_size * run_height;
+
+    float u = (float) run_width, v = (float) run_height;
+    float cell_x = (float) (tile % tile_count_x);
+    float cell_y = (float) (tile / tile_count_x);
+
+    float corners[6][4] = {
+        { left,  top,    0.0f, 0.0f },
+        { left,  bottom, 0.0f, v    },
+        { right, bottom, u,    v    },
+        { left,  top,    0.0f, 0.0f },
+        { right, bottom, u,    v    },
+        { right, top,    u,    0.0f }
+    };
+
+    for (int i = 0; i < 6; i++)
+    {
+        for (int j = 0; j < 4; j++) out[i * RUN_FLOATS_PER_VERTEX + j] = corners[i][j];
+        out[i * RUN_FLOATS_PER_VERTEX + 4] = cell_x;
+        out[i * RUN_FLOATS_PER_VERTEX + 5] = cell_y;
+    }
+}
+
+// Greedy merge: each tile not yet covered takes the longest stretch to its right with the same id,
+// then as many rows down as repeat that whole stretch. merged needs width * height entries; out can
+// be null to only count. Returns the vertex count
+constexpr int merge_tile_runs(const unsigned int *tiles, int width, int height, int tile_count_x, float tile_size,
+                              bool *merged, float *out)
+{
+    for (int i = 0; i < width * height; i++) merged[i] = false;
+    int vertex_count = 0;
+
+    for (int y = 0; y < height; y++)
+    {
+        for (int x = 0; x < width; x++)
+        {
+            if (merged[y * width + x]) continue;
+            unsigned int tile = tiles[y * width + x];
+
+            int run_width = 1;
+            while (x + run_width < width && !merged[y * width + x + run_width] &&
+                   tiles[y * width + x + run_width] == tile) run_width++;
+
+            int run_height = 1;
+            for (bool row_matches = true; row_matches && y + run_height < height; )
+            {
+                int row = (y + run_height) * width;
+                for (int i = x; i < x + run_width && row_matches; i++)
+                {
+                    row_matches = !merged[row + i] && tiles[row + i] == tile;
+                }
+                if (row_matches) run_height++;
+            }
+
+            for (int j = y; j < y + run_height; j++)
+            {
+                for (int i = x; i < x + run_width; i++) merged[j * width + i] = true;
+            }
+
+            if (out != nullptr)
+            {
+                write_tile_run(out + vertex_count * RUN_FLOATS_PER_VERTEX, tile, x, y, run_width, run_height,
+                               tile_size, tile_count_x);
+            }
+            vertex_count += 6;
+        }
+    }
+
+    return vertex_count;
+}
+
+/**
+ A built-in level worked out entirely by the compiler: the index texture's texels, the merged runs
+ (for a tile size of 1) and the collision bits all end up as read-only data, so building its Map is
+ only the upload. Declared constexpr next to the level array it comes from; an array that isn't
+ exactly WIDTH * HEIGHT tiles doesn't compile.
+ */
+template <int WIDTH, int HEIGHT, int TILE_COUNT_X>
+struct StaticLevel
+{
+    unsigned int  tiles[WIDTH * HEIGHT];
+    unsigned char texels[WIDTH * HEIGHT * 4];
+    float         run_vertices[WIDTH * HEIGHT * 6 * RUN_FLOATS_PER_VERTEX];
+    int           run_vertex_count;
+    uint32_t      solid_bits[(WIDTH * HEIGHT + 31) / 32];
+
+    constexpr StaticLevel(const unsigned int (&level_data)[WIDTH * HEIGHT])
+        : tiles(), texels(), run_vertices(), run_vertex_count(0), solid_bits()
+    {
+        for (int i = 0; i < WIDTH * HEIGHT; i++)
+        {
+            this->tiles[i] = level_data[i];
+
+            this->texels[i * 4]     = (unsigned char) (level_data[i] & 0xFF);
+            this->texels[i * 4 + 1] = (unsigned char) ((level_data[i] >> 8) & 0xFF);
+
+            if (level_data[i] > 0) this->solid_bits[i / 32] |= (uint32_t) 1 << (i % 32);
+        }
+
+        bool merged[WIDTH * HEIGHT] = {};
+        this->run_vertex_count = merge_tile_runs(level_data, WIDTH, HEIGHT, TILE_COUNT_X, 1.0f, merged, this->run_vertices);
+    }
+
+    // What Map takes; the template parameters become plain fields
+    operator StaticLevelData() const
+    {
+        StaticLevelData data = { WIDTH, HEIGHT, TILE_COUNT_X, this->tiles, this->texels,
+                                 this->run_vertices, this->run_vertex_count, this->solid_bits };
+        return data;
+    }
+};
@@ -0,0 +1,133 @@
+#include "TextRenderer.h"
+#include "Utility.h"
+
+void TextRenderer::load_font(const char *filepath, int columns, int rows)
+{
+    this->font_texture_id = Utility::load_texture(filepath);
+
+    // Start every character off as a full cell of a fixed grid (ASCII order); set_glyph_metrics can
+    // then narrow individual glyphs for proportional fonts
+    for (int i = 0; i < GLYPH_COUNT; i++)
+    {
+        GlyphMetrics metrics;
+        metrics.uv_width  = 1.0f / columns;
+        metrics.uv_height = 1.0f / rows;
+        metrics.u = (float) (i % columns) / columns;
+        metrics.v = (float) (i / columns) / rows;
+        metrics.width   = 1.0f;
+        metrics.advance = 1.0f;
+
+        this->glyphs[i] = metrics;
+    }
+
+    this->release();
+}
+
+void TextRenderer::set_glyph_metrics(unsigned char character, GlyphMetrics metrics)
+{
+    this->glyphs[character] = metrics;
+
+    // Anything already laid out used the old metrics
+    this->release();
+}
+
+CachedText *TextRenderer::get_cached(const std::string &text, float screen_size, float spacing)
+{
+    std::string key = std::to_string(screen_size) + ',' + std::to_string(spacing) + ',' + text;
+
+    std::unordered_map<std::string, CachedText>::iterator found = this->cache.find(key);
+    if (found != this->cache.end()) return &found->second;
+
+    // First time we've seen this string: lay it out once and keep it on the GPU
+    CachedText &cached = this->cache[key];
+    cached.vertices.reserve(text.size() * 24);
+
+    float pen = 0.0f;
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        const GlyphMetrics &glyph = this->glyphs[(unsigned char) text[i]];
+
+        float left   = pen - 0.5f * screen_size * glyph.width;
+        float right  = pen + 0.5f * screen_size * glyph.width;
+        float top    =  0.5f * screen_size;
+        float bottom = -0.5f * screen_size;
+
+        float u = glyph.u, v = glyph.v;
+        float u_right = u + glyph.uv_width, v_bottom = v + glyph.uv_height;
+
+        cached.vertices.insert(cached.vertices.end(), {
+            left,  top,    u,       v,
+            left,  bottom, u,       v_bottom,
+            right, top,    u_right, v,
+            right, bottom, u_right, v_bottom,
+            right, top,    u_right, v,
+            left,  bottom, u,       v_bottom,
+        });
+
+        pen += screen_size * glyph.advance + spacing;
+    }
+
+    cached.vertex_count = (int) cached.vertices.size() / 4;
+
+    glGenBuffers(1, &cached.buffer);
+    glBindBuffer(GL_ARRAY_BUFFER, cached.buffer);
+    glBufferData(GL_ARRAY_BUFFER, cached.vertices.size() * sizeof(float), cached.vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return &cached;
+}
+
+void TextRenderer::draw(const std::string &text, float screen_size, float spacing, glm::vec3 position)
+{
+    if (text.empty()) return;
+
+    // Trimmed before the first string of a frame, while nothing queued (here or in the render queue)
+    // still points into the cache
+    if (this->queue.empty() && this->cache.size() > TEXT_CACHE_LIMIT) this->release();
+
+    QueuedText queued = { this->get_cached(text, screen_size, spacing), position };
+    this->queue.push_back(queued);
+}
+
+void TextRenderer::flush(ShaderProgram *program, RenderQueue *render_queue)
+{
+    if (this->queue.empty()) return;
+
+    if (this->queue.size() == 1)
+    {
+        // The usual case (one dialogue line): the cached buffer is drawn as-is, nothing is uploaded
+        QueuedText &queued = this->queue[0];
+        render_queue->submit_buffer(TEXT_LAYER, program, this->font_texture_id, 0,
+                                    queued.text->buffer, queued.text->vertex_count, queued.position);
+    }
+    else
+    {
+        // Several strings: bake their positions in and stream them, so the queue draws them all at once
+        for (size_t i = 0; i < this->queue.size(); i++)
+        {
+            const std::vector<float> &vertices = this->queue[i].text->vertices;
+            glm::vec3 position = this->queue[i].position;
+
+            float *out = render_queue->submit(TEXT_LAYER, program, this->font_texture_id, 0, (int) vertices.size() / 4);
+            for (size_t j = 0; j < vertices.size(); j += 4)
+            {
+                out[j]     = vertices[j] + position.x;
+                out[j + 1] = vertices[j + 1] + position.y;
+                out[j + 2] = vertices[j + 2];
+                out[j + 3] = vertices[j + 3];
+            }
+        }
+    }
+
+    this->queue.clear();
+}
+
+void TextRenderer::release()
+{
+    for (std::unordered_map<std::string, CachedText>::iterator it = this->cache.begin(); it != this->cache.end(); it++)
+    {
+        glDeleteBuffers(1, &it->second.buffer);
+    }
+    this->cache.clear();
+    this->queue.clear();
+}
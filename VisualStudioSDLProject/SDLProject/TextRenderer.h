@@ -0,0 +1,66 @@
+#pragma once
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "ShaderProgram.h"
+#include "RenderQueue.h"
+
+#define GLYPH_COUNT 256
+#define TEXT_CACHE_LIMIT 256 // distinct strings kept on the GPU before the cache is flushed
+
+/**
+ Where a character sits in the font texture and how much room it takes up. width and advance are
+ fractions of the requested screen size, so a full grid cell is 1.0f for both.
+ */
+struct GlyphMetrics
+{
+    float u, v;
+    float uv_width, uv_height;
+    float width;
+    float advance;
+};
+
+struct CachedText
+{
+    std::vector<float> vertices; // x, y, u, v per vertex, relative to the start of the string
+    GLuint buffer = 0;
+    int vertex_count = 0;
+};
+
+struct QueuedText
+{
+    CachedText *text;
+    glm::vec3 position;
+};
+
+class TextRenderer {
+private:
+    GLuint font_texture_id = 0;
+    GlyphMetrics glyphs[GLYPH_COUNT];
+
+    std::unordered_map<std::string, CachedText> cache;
+    std::vector<QueuedText> queue;
+
+    CachedText *get_cached(const std::string &text, float screen_size, float spacing);
+
+public:
+    void load_font(const char *filepath, int columns, int rows);
+    void set_glyph_metrics(unsigned char character, GlyphMetrics metrics);
+
+    void draw(const std::string &text, float screen_size, float spacing, glm::vec3 position);
+    void flush(ShaderProgram *program, RenderQueue *render_queue);
+    void release();
+
+    bool const is_loaded() const { return this->font_texture_id != 0; }
+};
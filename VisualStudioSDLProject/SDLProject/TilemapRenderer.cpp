@@ -0,0 +1,169 @@
+#include "TilemapRenderer.h"
+#include "Map.h"
+
+bool TilemapRenderer::load(const char *vertex_shader_path, const char *fragment_shader_path, glm::mat4 projection_matrix)
+{
+    this->program.Load(vertex_shader_path, fragment_shader_path);
+
+    GLint link_success;
+    glGetProgramiv(this->program.programID, GL_LINK_STATUS, &link_success);
+    if (link_success == GL_FALSE) return false;
+
+    this->tile_indices_uniform = glGetUniformLocation(this->program.programID, "tileIndices");
+    this->map_size_uniform     = glGetUniformLocation(this->program.programID, "mapSize");
+    this->tileset_size_uniform = glGetUniformLocation(this->program.programID, "tilesetSize");
+    this->layer_count_uniform   = glGetUniformLocation(this->program.programID, "layerCount");
+    this->first_layer_uniform   = glGetUniformLocation(this->program.programID, "firstLayer");
+    this->last_layer_uniform    = glGetUniformLocation(this->program.programID, "lastLayer");
+    this->parallax_uniform      = glGetUniformLocation(this->program.programID, "parallax");
+    this->camera_offset_uniform = glGetUniformLocation(this->program.programID, "cameraOffset");
+
+    // Load() leaves the program current, so the parts that never change go in now
+    this->program.SetProjectionMatrix(projection_matrix);
+    this->program.SetModelMatrix(glm::mat4(1.0f));
+    glUniform1i(this->tile_indices_uniform, TILEMAP_TEXTURE_UNIT);
+
+    this->loaded = true;
+    return true;
+}
+
+bool TilemapRenderer::load_runs(const char *vertex_shader_path, const char *fragment_shader_path, glm::mat4 projection_matrix)
+{
+    this->run_program.Load(vertex_shader_path, fragment_shader_path);
+
+    GLint link_success;
+    glGetProgramiv(this->run_program.programID, GL_LINK_STATUS, &link_success);
+    if (link_success == GL_FALSE) return false;
+
+    this->run_tileset_size_uniform = glGetUniformLocation(this->run_program.programID, "tilesetSize");
+    this->tile_offset_attribute    = glGetAttribLocation(this->run_program.programID, "tileOffset");
+
+    this->run_program.SetProjectionMatrix(projection_matrix);
+    this->run_program.SetModelMatrix(glm::mat4(1.0f));
+
+    this->run_shader_loaded = true;
+    return true;
+}
+
+void TilemapRenderer::set_view(glm::mat4 view_matrix, VisibleRect visible)
+{
+    this->view_matrix = view_matrix;
+    this->visible     = visible;
+
+    // Last frame's queue has run by now
+    this->draws.clear();
+}
+
+void TilemapRenderer::submit(const Map *map, RenderQueue *queue)
+{
+    int collision_layer = map->get_collision_layer();
+
+    TilemapDraw draw = { this, map, 0, collision_layer };
+    this->draws.push_back(draw);
+    queue->submit_callback(MAP_LAYER, &this->program, map->get_texture_id(), 0, draw_callback, &this->draws.back());
+
+    if (collision_layer + 1 == map->get_layer_count()) return;
+
+    TilemapDraw foreground = { this, map, collision_layer + 1, map->get_layer_count() - 1 };
+    this->draws.push_back(foreground);
+    queue->submit_callback(FOREGROUND_LAYER, &this->program, map->get_texture_id(), 0, draw_callback, &this->draws.back());
+}
+
+void TilemapRenderer::submit_runs(const Map *map, RenderQueue *queue)
+{
+    TilemapDraw draw = { this, map, 0, 0 };
+    this->draws.push_back(draw);
+
+    queue->submit_callback(MAP_LAYER, &this->run_program, map->get_texture_id(), 0, draw_runs_callback, &this->draws.back());
+}
+
+void TilemapRenderer::draw_callback(void *data)
+{
+    TilemapDraw *draw = static_cast<TilemapDraw*>(data);
+    draw->renderer->draw(draw->map, draw->first_layer, draw->last_layer);
+}
+
+void TilemapRenderer::draw_runs_callback(void *data)
+{
+    TilemapDraw *draw = static_cast<TilemapDraw*>(data);
+    draw->renderer->draw_runs(draw->map);
+}
+
+void TilemapRenderer::draw(const Map *map, int first_layer, int last_layer)
+{
+    // Only the part of the map on screen gets a quad
+    float left   = fmax(this->visible.left,   map->get_left_bound());
+    float right  = fmin(this->visible.right,  map->get_right_bound());
+    float bottom = fmax(this->visible.bottom, map->get_bottom_bound());
+    float top    = fmin(this->visible.top,    map->get_top_bound());
+    if (left >= right || bottom >= top) return;
+
+    // Texture coordinates are in tiles from the map's top-left corner; the shader does the rest
+    float tile_size = map->get_tile_size();
+    float u_left   = (left - map->get_left_bound()) / tile_size;
+    float u_right  = (right - map->get_left_bound()) / tile_size;
+    float v_top    = (map->get_top_bound() - top) / tile_size;
+    float v_bottom = (map->get_top_bound() - bottom) / tile_size;
+
+    float vertices[] = { left, top, left, bottom, right, bottom, left, top, right, bottom, right, top };
+    float texture_coordinates[] = { u_left, v_top, u_left, v_bottom, u_right, v_bottom,
+                                    u_left, v_top, u_right, v_bottom, u_right, v_top };
+
+    this->program.SetViewMatrix(this->view_matrix);
+    glUniform2f(this->map_size_uniform, (float) map->get_width(), (float) map->get_height());
+    glUniform2f(this->tileset_size_uniform, (float) map->get_tile_count_x(), (float) map->get_tile_count_y());
+
+    // Parallax is measured from the map's centre, where every layer lines up
+    float parallax[MAP_MAX_LAYERS];
+    for (int i = 0; i < map->get_layer_count(); i++) parallax[i] = map->get_layer_parallax(i);
+
+    float camera_x = (this->visible.left + this->visible.right) / 2;
+    float camera_y = (this->visible.bottom + this->visible.top) / 2;
+    float center_x = (map->get_left_bound() + map->get_right_bound()) / 2;
+    float center_y = (map->get_bottom_bound() + map->get_top_bound()) / 2;
+
+    glUniform1f(this->layer_count_uniform, (float) map->get_layer_count());
+    glUniform1f(this->first_layer_uniform, (float) first_layer);
+    glUniform1f(this->last_layer_uniform,  (float) last_layer);
+    glUniform1fv(this->parallax_uniform, map->get_layer_count(), parallax);
+    glUniform2f(this->camera_offset_uniform, (camera_x - center_x) / tile_size, (center_y - camera_y) / tile_size);
+
+    glActiveTexture(GL_TEXTURE0 + TILEMAP_TEXTURE_UNIT);
+    glBindTexture(GL_TEXTURE_2D, map->get_index_texture_id());
+    glActiveTexture(GL_TEXTURE0);
+    glBindTexture(GL_TEXTURE_2D, map->get_texture_id());
+
+    glVertexAttribPointer(this->program.positionAttribute, 2, GL_FLOAT, false, 0, vertices);
+    glEnableVertexAttribArray(this->program.positionAttribute);
+    glVertexAttribPointer(this->program.texCoordAttribute, 2, GL_FLOAT, false, 0, texture_coordinates);
+    glEnableVertexAttribArray(this->program.texCoordAttribute);
+
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+
+    glDisableVertexAttribArray(this->program.positionAttribute);
+    glDisableVertexAttribArray(this->program.texCoordAttribute);
+}
+
+void TilemapRenderer::draw_runs(const Map *map)
+{
+    this->run_program.SetViewMatrix(this->view_matrix);
+    glUniform2f(this->run_tileset_size_uniform, (float) map->get_tile_count_x(), (float) map->get_tile_count_y());
+
+    glBindTexture(GL_TEXTURE_2D, map->get_texture_id());
+    glBindBuffer(GL_ARRAY_BUFFER, map->get_run_buffer());
+
+    GLsizei stride = RUN_FLOATS_PER_VERTEX * sizeof(float);
+    glVertexAttribPointer(this->run_program.positionAttribute, 2, GL_FLOAT, false, stride, (void*) 0);
+    glEnableVertexAttribArray(this->run_program.positionAttribute);
+    glVertexAttribPointer(this->run_program.texCoordAttribute, 2, GL_FLOAT, false, stride, (void*) (2 * sizeof(float)));
+    glEnableVertexAttribArray(this->run_program.texCoordAttribute);
+    glVertexAttribPointer(this->tile_offset_attribute, 2, GL_FLOAT, false, stride, (void*) (4 * sizeof(float)));
+    glEnableVertexAttribArray(this->tile_offset_attribute);
+
+    glDrawArrays(GL_TRIANGLES, 0, map->get_run_vertex_count());
+
+    glDisableVertexAttribArray(this->run_program.positionAttribute);
+    glDisableVertexAttribArray(this->run_program.texCoordAttribute);
+    glDisableVertexAttribArray(this->tile_offset_attribute);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
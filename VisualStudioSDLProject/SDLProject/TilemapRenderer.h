@@ -0,0 +1,80 @@
+#pragma once
+#define GL_SILENCE_DEPRECATION
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+#define GL_GLEXT_PROTOTYPES 1
+#include <deque>
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "ShaderProgram.h"
+#include "RenderQueue.h"
+#include "Camera.h"
+
+class Map;
+
+#define TILEMAP_TEXTURE_UNIT 1 // the tileset stays on unit 0, the index texture goes here
+
+/**
+ Draws an indexed map as one quad over whatever part of it the camera can see. The fragment shader
+ looks each pixel's tile up in the map's index texture and samples the tileset from that, so the
+ map costs four corners however big it is. Every layer under the sprites is composited in that one
+ pass, with the tileset bound once; foreground layers take a second pass above the sprites. Maps drawn as quads come through here as well, as
+ merged runs that wrap their tile with their own shader.
+ */
+class TilemapRenderer {
+private:
+    struct TilemapDraw
+    {
+        TilemapRenderer *renderer;
+        const Map *map;
+        int first_layer;
+        int last_layer;
+    };
+
+    ShaderProgram program;
+    bool loaded = false;
+
+    GLint tile_indices_uniform;
+    GLint map_size_uniform;
+    GLint tileset_size_uniform;
+    GLint layer_count_uniform;
+    GLint first_layer_uniform;
+    GLint last_layer_uniform;
+    GLint parallax_uniform;
+    GLint camera_offset_uniform;
+
+    ShaderProgram run_program;
+    bool run_shader_loaded = false;
+
+    GLint run_tileset_size_uniform;
+    GLint tile_offset_attribute;
+
+    glm::mat4 view_matrix = glm::mat4(1.0f);
+    VisibleRect visible;
+
+    // Queued draws point in here until the queue runs, so it must not move them
+    std::deque<TilemapDraw> draws;
+
+    static void draw_callback(void *data);
+    static void draw_runs_callback(void *data);
+    void draw(const Map *map, int first_layer, int last_layer);
+    void draw_runs(const Map *map);
+
+public:
+    // False when the shader failed to build; maps then fall back to their own quads
+    bool load(const char *vertex_shader_path, const char *fragment_shader_path, glm::mat4 projection_matrix);
+    bool const is_loaded() const { return this->loaded; }
+
+    // Same again for the shader that draws merged runs
+    bool load_runs(const char *vertex_shader_path, const char *fragment_shader_path, glm::mat4 projection_matrix);
+    bool const is_run_shader_loaded() const { return this->run_shader_loaded; }
+
+    // Once a frame, before the scene renders
+    void set_view(glm::mat4 view_matrix, VisibleRect visible);
+
+    void submit(const Map *map, RenderQueue *queue);
+    void submit_runs(const Map *map, RenderQueue *queue);
+};
@@ -6,6 +6,7 @@
 #define FONTBANK_SIZE 16
 
 #include "Utility.h"
+#include "TextRenderer.h"
 #include <SDL_image.h>
 #include "stb_image.h"
 
@@ -42,66 +43,37 @@ GLuint Utility::load_texture(const char* filepath) {
     return texture_id;
 }
 
-void Utility::draw_text(ShaderProgram *program, std::string text, float screen_size, float spacing, glm::vec3 position)
-{
-    GLuint font_texture_id = load_texture(FONT_FILEPATH);
-    // Scale the size of the fontbank in the UV-plane
-    // We will use this for spacing and positioning
-    float width = 1.0f / FONTBANK_SIZE;
-    float height = 1.0f / FONTBANK_SIZE;
-
-    // Instead of having a single pair of arrays, we'll have a series of pairs—one for each character
-    // Don't forget to include <vector>!
-    std::vector<float> vertices;
-    std::vector<float> texture_coordinates;
+static TextRenderer text_renderer;
+static RenderQueue render_queue;
+static TilemapRenderer tilemap_renderer;
 
-    // For every character...
-    for (int i = 0; i < text.size(); i++) {
-        // 1. Get their index in the spritesheet, as well as their offset (i.e. their position
-        //    relative to the whole sentence)
-        int spritesheet_index = (int) text[i];  // ascii value of character
-        float offset = (screen_size + spacing) * i;
-        
-        // 2. Using the spritesheet index, we can calculate our U- and V-coordinates
-        float u_coordinate = (float) (spritesheet_index % FONTBANK_SIZE) / FONTBANK_SIZE;
-        float v_coordinate = (float) (spritesheet_index / FONTBANK_SIZE) / FONTBANK_SIZE;
+void Utility::draw_text(ShaderProgram *, std::string text, float screen_size, float spacing, glm::vec3 position)
+{
+    // The program is only needed when the queued text is flushed; the parameter stays so scenes don't change
+    if (!text_renderer.is_loaded()) text_renderer.load_font(FONT_FILEPATH, FONTBANK_SIZE, FONTBANK_SIZE);
+    
+    // Only queued here; every string drawn this frame goes out with the rest of the frame in flush_render
+    text_renderer.draw(text, screen_size, spacing, position);
+}
 
-        // 3. Inset the current pair in both vectors
-        vertices.insert(vertices.end(), {
-            offset + (-0.5f * screen_size), 0.5f * screen_size,
-            offset + (-0.5f * screen_size), -0.5f * screen_size,
-            offset + (0.5f * screen_size), 0.5f * screen_size,
-            offset + (0.5f * screen_size), -0.5f * screen_size,
-            offset + (0.5f * screen_size), 0.5f * screen_size,
-            offset + (-0.5f * screen_size), -0.5f * screen_size,
-        });
+RenderQueue &Utility::get_render_queue()
+{
+    return render_queue;
+}
 
-        texture_coordinates.insert(texture_coordinates.end(), {
-            u_coordinate, v_coordinate,
-            u_coordinate, v_coordinate + height,
-            u_coordinate + width, v_coordinate,
-            u_coordinate + width, v_coordinate + height,
-            u_coordinate + width, v_coordinate,
-            u_coordinate, v_coordinate + height,
-        });
-    }
+TilemapRenderer &Utility::get_tilemap_renderer()
+{
+    return tilemap_renderer;
+}
 
-    // 4. And render all of them using the pairs
-    glm::mat4 model_matrix = glm::mat4(1.0f);
-    model_matrix = glm::translate(model_matrix, position);
-    
-    program->SetModelMatrix(model_matrix);
-    glUseProgram(program->programID);
-    
-    glVertexAttribPointer(program->positionAttribute, 2, GL_FLOAT, false, 0, vertices.data());
-    glEnableVertexAttribArray(program->positionAttribute);
-    glVertexAttribPointer(program->texCoordAttribute, 2, GL_FLOAT, false, 0, texture_coordinates.data());
-    glEnableVertexAttribArray(program->texCoordAttribute);
-    
-    glBindTexture(GL_TEXTURE_2D, font_texture_id);
-    glDrawArrays(GL_TRIANGLES, 0, (int) (text.size() * 6));
-    
-    glDisableVertexAttribArray(program->positionAttribute);
-    glDisableVertexAttribArray(program->texCoordAttribute);
+void Utility::flush_render(ShaderProgram *program)
+{
+    text_renderer.flush(program, &render_queue);
+    render_queue.execute();
 }
 
+void Utility::release_text()
+{
+    text_renderer.release();
+    render_queue.release();
+}
@@ -12,9 +12,19 @@
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 #include "ShaderProgram.h"
+#include "RenderQueue.h"
+#include "TilemapRenderer.h"
 
 class Utility {
 public:
     static GLuint load_texture(const char* filepath);
     static void draw_text(ShaderProgram *program, std::string text, float screen_size, float spacing, glm::vec3 position);
+    static void release_text();
+    
+    // Everything the scene drew this frame, plus queued text, goes to GL here in one sorted pass
+    static RenderQueue &get_render_queue();
+    static void flush_render(ShaderProgram *program);
+    
+    // Draws indexed maps; main loads it once the GL context is up
+    static TilemapRenderer &get_tilemap_renderer();
 };
@@ -0,0 +1,124 @@
+#include "VisibilitySystem.h"
+#include <algorithm>
+
+// Where the entity was last drawn, which is what the camera has to contain
+static glm::vec3 drawn_position(Entity *entity)
+{
+    return glm::vec3(entity->model_matrix[3]);
+}
+
+void VisibilitySystem::build(Map *map)
+{
+    this->left_bound = map->get_left_bound();
+    this->top_bound  = map->get_top_bound();
+
+    this->grid_width  = (int) ceil((map->get_right_bound() - map->get_left_bound()) / VISIBILITY_CELL_SIZE);
+    this->grid_height = (int) ceil((map->get_top_bound() - map->get_bottom_bound()) / VISIBILITY_CELL_SIZE);
+    if (this->grid_width  < 1) this->grid_width  = 1;
+    if (this->grid_height < 1) this->grid_height = 1;
+
+    this->cells.assign(this->grid_width * this->grid_height, std::vector<int>());
+}
+
+void VisibilitySystem::add(Entity *entity)
+{
+    int cell = this->cell_of(drawn_position(entity));
+
+    entity->visibility       = this;
+    entity->visibility_index = (int) this->entities.size();
+    entity->visibility_cell  = cell;
+
+    this->cells[cell].push_back((int) this->entities.size());
+    this->entity_cells.push_back(cell);
+    this->entities.push_back(entity);
+}
+
+void VisibilitySystem::clear()
+{
+    this->entities.clear();
+    this->entity_cells.clear();
+    this->visible.clear();
+    for (size_t i = 0; i < this->cells.size(); i++) this->cells[i].clear();
+}
+
+int const VisibilitySystem::cell_of(glm::vec3 position) const
+{
+    int cell_x = (int) floor((position.x - this->left_bound) / VISIBILITY_CELL_SIZE);
+    int cell_y = (int) floor((this->top_bound - position.y) / VISIBILITY_CELL_SIZE);
+
+    // Anything that has wandered off the map is kept in the nearest edge cell
+    if (cell_x < 0) cell_x = 0;
+    if (cell_y < 0) cell_y = 0;
+    if (cell_x >= this->grid_width)  cell_x = this->grid_width - 1;
+    if (cell_y >= this->grid_height) cell_y = this->grid_height - 1;
+
+    return cell_y * this->grid_width + cell_x;
+}
+
+void VisibilitySystem::move_to_cell(int entity_index, int new_cell)
+{
+    int old_cell = this->entity_cells[entity_index];
+    if (old_cell == new_cell) return;
+
+    std::vector<int> &old_bucket = this->cells[old_cell];
+    for (size_t i = 0; i < old_bucket.size(); i++)
+    {
+        if (old_bucket[i] == entity_index)
+        {
+            old_bucket[i] = old_bucket.back();
+            old_bucket.pop_back();
+            break;
+        }
+    }
+
+    this->cells[new_cell].push_back(entity_index);
+    this->entity_cells[entity_index] = new_cell;
+}
+
+void VisibilitySystem::cull(const Camera *camera)
+{
+    this->visible.clear();
+
+    if (camera == NULL)
+    {
+        for (size_t i = 0; i < this->entities.size(); i++)
+        {
+            if (this->entities[i]->get_active_state()) this->visible.push_back((int) i);
+        }
+        return;
+    }
+
+    // Entities are bucketed by their centre, so widen the rectangle by a sprite's half size to catch
+    // anything poking in from a neighbouring cell
+    VisibleRect rect = camera->get_visible_rect();
+
+    int first_cell = this->cell_of(glm::vec3(rect.left  - VISIBILITY_HALF_EXTENT, rect.top    + VISIBILITY_HALF_EXTENT, 0.0f));
+    int last_cell  = this->cell_of(glm::vec3(rect.right + VISIBILITY_HALF_EXTENT, rect.bottom - VISIBILITY_HALF_EXTENT, 0.0f));
+
+    int min_x = first_cell % this->grid_width, min_y = first_cell / this->grid_width;
+    int max_x = last_cell  % this->grid_width, max_y = last_cell  / this->grid_width;
+
+    for (int y = min_y; y <= max_y; y++)
+    {
+        for (int x = min_x; x <= max_x; x++)
+        {
+            std::vector<int> &bucket = this->cells[y * this->grid_width + x];
+
+            for (size_t i = 0; i < bucket.size(); i++)
+            {
+                Entity *entity = this->entities[bucket[i]];
+                if (!entity->get_active_state()) continue;
+
+                if (rect.contains(drawn_position(entity), VISIBILITY_HALF_EXTENT)) this->visible.push_back(bucket[i]);
+            }
+        }
+    }
+
+    // Draw in the order entities were added, as before, so overlapping sprites don't swap
+    std::sort(this->visible.begin(), this->visible.end());
+}
+
+void VisibilitySystem::render(ShaderProgram *program)
+{
+    for (size_t i = 0; i < this->visible.size(); i++) this->entities[this->visible[i]]->render(program);
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include <vector>
+#include "Entity.h"
+#include "Camera.h"
+
+// Distances are in world units (one tile is 1.0f in every scene)
+#define VISIBILITY_CELL_SIZE 4.0f
+#define VISIBILITY_HALF_EXTENT 0.5f // sprites draw as a unit quad around their position
+
+/**
+ Buckets entities into a coarse grid over the map so each frame only the cells under the camera are
+ looked at. What's found is tested against the visible rectangle and drawn; everything else never
+ reaches a GL call. Entities re-bucket themselves during the update, through a CELL_EVENT when they
+ cross into another cell, so culling costs nothing for entities off screen.
+ */
+class VisibilitySystem {
+private:
+    std::vector<Entity*> entities;
+    std::vector<int> entity_cells;       // cell each entity is bucketed in
+    std::vector<std::vector<int>> cells; // indices into entities
+    std::vector<int> visible;            // indices into entities, in the order they were added
+
+    int grid_width  = 1;
+    int grid_height = 1;
+    float left_bound = 0.0f;
+    float top_bound  = 0.0f;
+
+public:
+    // Safe to call from entity updates on any thread; move_to_cell is only called when events resolve
+    int const cell_of(glm::vec3 position) const;
+    void move_to_cell(int entity_index, int new_cell);
+
+    void build(Map *map);
+    void add(Entity *entity);
+    void clear();
+
+    // Fills the visible list; with no camera everything active counts as visible (and every entity is looked at)
+    void cull(const Camera *camera);
+    void render(ShaderProgram *program);
+
+    int const get_count()         const { return (int) this->entities.size(); }
+    int const get_visible_count() const { return (int) this->visible.size();  }
+};
@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ A fixed set of worker threads, each with its own job queue. A worker takes from the back of its own
+ queue and, once that's empty, steals from the front of someone else's, so uneven jobs (a range of
+ sleeping enemies next to a range of chasing ones) still keep every core busy.
+ */
+class WorkStealingPool {
+public:
+    typedef std::function<void()> Job;
+
+private:
+    struct WorkerQueue
+    {
+        std::mutex lock;
+        std::deque<Job> jobs;
+    };
+
+    std::vector<std::thread> threads;
+    std::vector<std::unique_ptr<WorkerQueue> > queues;
+
+    std::atomic<int> queued;   // jobs sitting in a queue
+    std::atomic<int> pending;  // jobs submitted and not yet finished
+    std::atomic<unsigned> next_queue;
+    bool stopping = false;
+
+    std::mutex sleep_lock;
+    std::condition_variable wake;
+    std::condition_variable finished;
+
+    bool take(int index, Job &job);
+    void run(Job &job);
+    void run_worker(int index);
+
+public:
+    // 0 threads means one per core
+    explicit WorkStealingPool(int thread_count = 0);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    void submit(Job job);
+
+    // Until every job submitted so far has finished, running some of them meanwhile. Not from inside
+    // one of this pool's own jobs: that job counts as unfinished, so it would wait on itself
+    void wait();
+
+    // The calling thread's queue in this pool; -1 for threads that aren't its workers
+    int const get_worker_index() const;
+
+    int const get_thread_count() const { return (int) this->threads.size(); }
+};
@@ -1,10 +1,14 @@
 #define GL_SILENCE_DEPRECATION
 #define GL_GLEXT_PROTOTYPES 1
 #define FIXED_TIMESTEP 0.0166666f
-#define LEVEL1_WIDTH 14
-#define LEVEL1_HEIGHT 8
-#define LEVEL1_LEFT_EDGE 4.5f
-#define LEVEL1_RIGHT_EDGE 8.5f
+#define CAMERA_DEAD_ZONE_X 0.75f
+#define CAMERA_DEAD_ZONE_Y 0.5f
+#define CAMERA_SMOOTHING 8.0f
+#define INPUT_WAIT_MS 10
+#define FRAME_PACING_MODE VSYNC_PACING
+#define FRAME_RATE_CAP 60.0f // capped and on-demand pacing only
+#define IDLE_WAIT_MS 250     // longest an idle scene sleeps without input
+#define ARENA_REPORT 0       // 1 prints every scene's arena high-water mark at shutdown
 
 #ifdef _WINDOWS
 #include <GL/glew.h>
@@ -17,11 +21,16 @@
 #include "glm/gtc/matrix_transform.hpp"
 #include "ShaderProgram.h"
 #include "cmath"
+#include <atomic>
 #include <ctime>
+#include <thread>
 #include <vector>
 #include "Entity.h"
 #include "Map.h"
 #include "Utility.h"
+#include "InputRing.h"
+#include "Camera.h"
+#include "FramePacer.h"
 #include "Scene.h"
 #include "LevelA.h"
 #include "sceneA.h"
@@ -49,13 +58,19 @@ const float BG_RED     = 0.502f,
             BG_GREEN   = 0.502f,
             BG_OPACITY = 1.0f;
 
+const float VIEW_HALF_WIDTH  = 5.0f,
+            VIEW_HALF_HEIGHT = 3.75f;
+
 const int VIEWPORT_X = 0,
           VIEWPORT_Y = 0,
           VIEWPORT_WIDTH  = WINDOW_WIDTH,
           VIEWPORT_HEIGHT = WINDOW_HEIGHT;
 
 const char V_SHADER_PATH[] = "shaders/vertex_textured.glsl",
-           F_SHADER_PATH[] = "shaders/fragment_textured.glsl";
+           F_SHADER_PATH[] = "shaders/fragment_textured.glsl",
+           TILEMAP_F_SHADER_PATH[] = "shaders/fragment_tilemap.glsl",
+           TILERUN_V_SHADER_PATH[] = "shaders/vertex_tilerun.glsl",
+           TILERUN_F_SHADER_PATH[] = "shaders/fragment_tilerun.glsl";
 
 const float MILLISECONDS_IN_SECOND = 1000.0;
 
@@ -76,19 +91,33 @@ sceneJ* scene_j;
 
 
 SDL_Window* display_window;
-bool game_is_running = true;
+SDL_GLContext context;
+std::atomic<bool> game_is_running(true);
+
+// Filled by the input thread (main), drained by the game thread at the start of every fixed step
+InputRing input_ring;
+bool key_held[SDL_NUM_SCANCODES] = { false };
 
 ShaderProgram program;
 glm::mat4 view_matrix, projection_matrix;
+Camera camera(VIEW_HALF_WIDTH, VIEW_HALF_HEIGHT);
 
-float previous_ticks = 0.0f;
+Uint64 previous_counter = 0;
 float accumulator = 0.0f;
 
 void switch_to_scene(Scene *scene, int decision=0)
 {
+    // The scene being left gives up its map, entities, textures and audio before the next one loads
+    if (current_scene != NULL) current_scene->release();
+    
     current_scene = scene;
      current_scene->initialise();
+    current_scene->dirty = true;
     if (decision) current_scene->decision = decision;
+    
+    current_scene->state.camera = &camera;
+    camera.snap(current_scene->state.player->get_position(), current_scene->state.map);
+    view_matrix = camera.get_view_matrix();
 }
 
 void initialise()
@@ -99,7 +128,7 @@ void initialise()
                                       WINDOW_WIDTH, WINDOW_HEIGHT,
                                       SDL_WINDOW_OPENGL);
     
-    SDL_GLContext context = SDL_GL_CreateContext(display_window);
+    context = SDL_GL_CreateContext(display_window);
     SDL_GL_MakeCurrent(display_window, context);
     
 #ifdef _WINDOWS
@@ -111,15 +140,23 @@ void initialise()
     program.Load(V_SHADER_PATH, F_SHADER_PATH);
     
     view_matrix = glm::mat4(1.0f);
-    projection_matrix = glm::ortho(-5.0f, 5.0f, -3.75f, 3.75f, -1.0f, 1.0f);
+    projection_matrix = glm::ortho(-VIEW_HALF_WIDTH, VIEW_HALF_WIDTH, -VIEW_HALF_HEIGHT, VIEW_HALF_HEIGHT, -1.0f, 1.0f);
     
     program.SetProjectionMatrix(projection_matrix);
     program.SetViewMatrix(view_matrix);
     
+    // Indexed maps draw through their own shader; if it won't build they fall back to merged runs,
+    // and without that shader either, to a quad per tile
+    Utility::get_tilemap_renderer().load(V_SHADER_PATH, TILEMAP_F_SHADER_PATH, projection_matrix);
+    Utility::get_tilemap_renderer().load_runs(TILERUN_V_SHADER_PATH, TILERUN_F_SHADER_PATH, projection_matrix);
+    
     glUseProgram(program.programID);
     
     glClearColor(BG_RED, BG_BLUE, BG_GREEN, BG_OPACITY);
     
+    camera.set_dead_zone(CAMERA_DEAD_ZONE_X, CAMERA_DEAD_ZONE_Y);
+    camera.set_smoothing(CAMERA_SMOOTHING);
+    
     scene_a = new sceneA();
     scene_b = new sceneB();
     scene_c = new sceneC();
@@ -138,14 +175,43 @@ void initialise()
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 }
 
-void process_input()
+void capture_input()
+{
+    // SDL only pumps events on the thread that made the window, so this is main's whole job once the game
+    // thread has started: stamp each event as it arrives and hand it over
+    SDL_Event event;
+    while (game_is_running)
+    {
+        if (!SDL_WaitEventTimeout(&event, INPUT_WAIT_MS)) continue;
+        if (event.type != SDL_QUIT && event.type != SDL_KEYDOWN && event.type != SDL_KEYUP && event.type != SDL_WINDOWEVENT) continue;
+        
+        // Window events only get as far as marking the scene dirty (e.g. exposed after being covered)
+        InputEvent input = { SDL_GetPerformanceCounter(), event.type, 0, 0 };
+        if (event.type == SDL_KEYDOWN || event.type == SDL_KEYUP)
+        {
+            input.key      = event.key.keysym.sym;
+            input.scancode = event.key.keysym.scancode;
+        }
+        
+        // The game thread has fallen a whole ring behind; wait for it rather than lose a key release
+        while (!input_ring.push(input) && game_is_running) SDL_Delay(1);
+    }
+}
+
+void process_input(Uint64 step_end)
 {
     // VERY IMPORTANT: If nothing is pressed, we don't want to go anywhere
     current_scene->state.player->set_movement(glm::vec3(0.0f));
     
-    SDL_Event event;
-    while (SDL_PollEvent(&event))
+    // Only what had happened by the end of this step; anything later waits for the step it landed in
+    InputEvent event;
+    while (input_ring.peek(event) && event.timestamp <= step_end)
     {
+        input_ring.pop();
+        current_scene->dirty = true;
+        
+        if (event.type == SDL_KEYDOWN || event.type == SDL_KEYUP) key_held[event.scancode] = event.type == SDL_KEYDOWN;
+        
         switch (event.type) {
             // End game
             case SDL_QUIT:
@@ -154,7 +220,7 @@ void process_input()
                 break;
                 
             case SDL_KEYDOWN:
-                switch (event.key.keysym.sym) {
+                switch (event.key) {
                     case SDLK_q:
                         // Quit the game with a keystroke
                         game_is_running = false;
@@ -163,9 +229,7 @@ void process_input()
                     case SDLK_j:
                         // Attack (direction depends on movement)
                         current_scene->state.player->is_attacking = true;
-                        current_scene->state.player->is_attacking_index = true;
-                        current_scene->state.player->animation_index = 0;
-                        current_scene->state.player->animation_indices = current_scene->state.player->attacking[current_scene->state.player->RIGHT];
+                        current_scene->state.player->start_attack_animation(current_scene->state.player->attacking[current_scene->state.player->RIGHT]);
                         break;
                     case SDLK_RETURN: // ADDITION: better advancement system
                         switch (current_scene->next_scene_id) {
@@ -203,46 +267,40 @@ void process_input()
         }
     }
     
-    const Uint8 *key_state = SDL_GetKeyboardState(NULL);
-
 
-    if (key_state[SDL_SCANCODE_A])
+    if (key_held[SDL_SCANCODE_A])
     {
         current_scene->state.player->movement.x = -1.0f;
         current_scene->state.player->orientation.x = -1.0f;
         current_scene->state.player->orientation.y = 0.0f;
         // ADDITION: diagnal attacks needs to be fixed - orientation
 
-        current_scene->state.player->animation_indices = current_scene->state.player->walking[current_scene->state.player->LEFT];
-        if (current_scene->state.player->is_attacking_index) current_scene->state.player->animation_indices = current_scene->state.player->attacking[current_scene->state.player->LEFT];
+        current_scene->state.player->set_animation(current_scene->state.player->is_attack_animating() ? current_scene->state.player->attacking[current_scene->state.player->LEFT] : current_scene->state.player->walking[current_scene->state.player->LEFT]);
     }
-    else if (key_state[SDL_SCANCODE_D])
+    else if (key_held[SDL_SCANCODE_D])
     {
         current_scene->state.player->movement.x = 1.0f;
         current_scene->state.player->orientation.x = 1.0f;
         current_scene->state.player->orientation.y = 0.0f;
 
-        current_scene->state.player->animation_indices = current_scene->state.player->walking[current_scene->state.player->RIGHT];
-        if (current_scene->state.player->is_attacking_index) current_scene->state.player->animation_indices = current_scene->state.player->attacking[current_scene->state.player->RIGHT];
+        current_scene->state.player->set_animation(current_scene->state.player->is_attack_animating() ? current_scene->state.player->attacking[current_scene->state.player->RIGHT] : current_scene->state.player->walking[current_scene->state.player->RIGHT]);
     }
 
-    if (key_state[SDL_SCANCODE_W])
+    if (key_held[SDL_SCANCODE_W])
     {
         current_scene->state.player->movement.y = 1.0f;
         current_scene->state.player->orientation.x = 0.0f;
         current_scene->state.player->orientation.y = 1.0f;
 
-        current_scene->state.player->animation_indices = current_scene->state.player->walking[current_scene->state.player->UP];
-        if (current_scene->state.player->is_attacking_index) current_scene->state.player->animation_indices = current_scene->state.player->attacking[current_scene->state.player->UP];
+        current_scene->state.player->set_animation(current_scene->state.player->is_attack_animating() ? current_scene->state.player->attacking[current_scene->state.player->UP] : current_scene->state.player->walking[current_scene->state.player->UP]);
     }
-    else if (key_state[SDL_SCANCODE_S])
+    else if (key_held[SDL_SCANCODE_S])
     {
         current_scene->state.player->movement.y = -1.0f;
         current_scene->state.player->orientation.x = 0.0f;
         current_scene->state.player->orientation.y = -1.0f;
 
-        current_scene->state.player->animation_indices = current_scene->state.player->walking[current_scene->state.player->DOWN];
-        if (current_scene->state.player->is_attacking_index) current_scene->state.player->animation_indices = current_scene->state.player->attacking[current_scene->state.player->DOWN];
+        current_scene->state.player->set_animation(current_scene->state.player->is_attack_animating() ? current_scene->state.player->attacking[current_scene->state.player->DOWN] : current_scene->state.player->walking[current_scene->state.player->DOWN]);
     }
     
     if (glm::length(current_scene->state.player->movement) > 1.0f)
@@ -258,53 +316,63 @@ void process_input()
     // ADDITION: grounding the player when attacking could be a choice, but needs enemy knockback.
 }
 
-void update()
+bool update()
 {
-    float ticks = (float)SDL_GetTicks() / MILLISECONDS_IN_SECOND;
-    float delta_time = ticks - previous_ticks;
-    previous_ticks = ticks;
+    // Same clock the input thread stamps events with, so each step can tell which events are its own
+    Uint64 counter = SDL_GetPerformanceCounter();
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    float delta_time = (float)(counter - previous_counter) / frequency;
+    previous_counter = counter;
     
     delta_time += accumulator;
     
     if (delta_time < FIXED_TIMESTEP)
     {
         accumulator = delta_time;
-        return;
+        return false;
     }
     
+    // What an idle scene's picture depends on, to tell whether these steps changed it
+    Scene *stepped_scene = current_scene;
+    glm::vec3 player_before = current_scene->state.player->get_position();
+    glm::vec4 frame_before  = current_scene->state.player->get_animation_uv();
+    glm::vec3 camera_before = camera.get_position();
+    
     while (delta_time >= FIXED_TIMESTEP) {
+        // This step covers the FIXED_TIMESTEP of real time ending here
+        process_input(counter - (Uint64)((delta_time - FIXED_TIMESTEP) * frequency));
         current_scene->update(FIXED_TIMESTEP);
+        camera.follow(current_scene->state.player->get_position(), current_scene->state.map, FIXED_TIMESTEP);
         
         delta_time -= FIXED_TIMESTEP;
     }
     
     accumulator = delta_time;
     
+    if (current_scene == stepped_scene &&
+        (current_scene->state.player->get_position() != player_before ||
+         current_scene->state.player->get_animation_uv() != frame_before ||
+         camera.get_position() != camera_before)) current_scene->dirty = true;
     
-    // Prevent the camera from showing anything outside of the "edge" of the level
-    view_matrix = glm::mat4(1.0f);
+    // The camera keeps itself inside the current map
+    view_matrix = camera.get_view_matrix();
     
-    if (current_scene->state.player->get_position().x > LEVEL1_LEFT_EDGE && current_scene->state.player->get_position().x < LEVEL1_RIGHT_EDGE) {
-        view_matrix = glm::translate(view_matrix, glm::vec3(-current_scene->state.player->get_position().x, 3.5, 0));
-    } 
-    else if (current_scene->state.player->get_position().x <= LEVEL1_LEFT_EDGE) {
-        view_matrix = glm::translate(view_matrix, glm::vec3(-4.5, 3.5, 0));
-    }
-    else if (current_scene->state.player->get_position().x >= LEVEL1_RIGHT_EDGE)
-    {
-        view_matrix = glm::translate(view_matrix, glm::vec3(-8.5, 3.5, 0));
-    }
     // Death
     if (current_scene->state.player->get_health() <= 0) switch_to_scene(scene_j);
+    
+    return true;
 }
 
 void render()
 {
     program.SetViewMatrix(view_matrix);
+    Utility::get_tilemap_renderer().set_view(view_matrix, camera.get_visible_rect());
     
     glClear(GL_COLOR_BUFFER_BIT);
     
     current_scene->render(&program);
+    Utility::flush_render(&program);
+    current_scene->dirty = false;
 
     if (current_scene->completed)
     {
@@ -330,8 +398,49 @@ void render()
     SDL_GL_SwapWindow(display_window);
 }
 
+void run_game()
+{
+    SDL_GL_MakeCurrent(display_window, context);
+    previous_counter = SDL_GetPerformanceCounter();
+    
+    FramePacer pacer(FRAME_PACING_MODE, FRAME_RATE_CAP);
+    
+    while (game_is_running)
+    {
+        pacer.begin_frame();
+        
+        if (current_scene->idle && !current_scene->dirty)
+        {
+            // Nothing on screen can change until a key comes in, so sleep until then. Time spent here
+            // isn't simulated; the clock restarts one step back so whatever woke us is handled at once
+            input_ring.wait(IDLE_WAIT_MS);
+            previous_counter = SDL_GetPerformanceCounter() - (Uint64)(FIXED_TIMESTEP * SDL_GetPerformanceFrequency());
+            accumulator = 0.0f;
+        }
+        
+        bool advanced = update();
+        bool rendered = current_scene->idle ? current_scene->dirty : pacer.should_render(advanced);
+        if (rendered) render();
+        
+        pacer.end_frame(rendered);
+    }
+    
+    // Last thing with the context current: scene textures, buffers and audio, then the text cache
+    Scene *scenes[] = { scene_a, scene_b, scene_c, scene_d, scene_e, scene_f, scene_g, scene_h, scene_i, scene_j };
+    for (int i = 0; i < 10; i++) scenes[i]->release();
+    Utility::release_text();
+}
+
 void shutdown()
 {    
+#if ARENA_REPORT
+    Scene *scenes[] = { scene_a, scene_b, scene_c, scene_d, scene_e, scene_f, scene_g, scene_h, scene_i, scene_j };
+    for (int i = 0; i < 10; i++)
+    {
+        std::cout << "scene " << (char) ('A' + i) << " arena high-water mark: " << scenes[i]->state.arena.get_high_water_mark() << " bytes\n";
+    }
+#endif
+    
     SDL_Quit();
     
     delete scene_a;
@@ -354,13 +463,13 @@ int main(int argc, char* argv[])
 {
     initialise();
     
-    while (game_is_running)
-    {
-        process_input();
-        update();
-        render();
-    }
+    // The game thread simulates and renders; main stays behind to capture input
+    SDL_GL_MakeCurrent(display_window, NULL);
+    std::thread game_thread(run_game);
+    
+    capture_input();
     
+    game_thread.join();
     shutdown();
     return 0;
 }
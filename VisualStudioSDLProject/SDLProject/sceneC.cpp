@@ -1,11 +1,12 @@
 // 2
 #include "sceneC.h"
 #include "Utility.h"
+#include "StaticLevel.h"
 
 #define LEVEL_WIDTH 14
 #define LEVEL_HEIGHT 8
 
-unsigned int sceneC_DATA[] =
+constexpr unsigned int sceneC_DATA[] =
 {
     3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3,
     1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 2,
@@ -17,48 +18,50 @@ unsigned int sceneC_DATA[] =
     4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4, 4
 };
 
+// Texels, merged runs and collision bits, all worked out by the compiler
+constexpr StaticLevel<LEVEL_WIDTH, LEVEL_HEIGHT, 7> sceneC_LEVEL(sceneC_DATA);
+
 sceneC::~sceneC()
 {
-    delete[] this->state.enemies;
-    delete    this->state.player;
-    delete    this->state.map;
-    Mix_FreeChunk(this->state.jump_sfx);
-    Mix_FreeMusic(this->state.bgm);
+    this->state.arena.reset();
 }
 
 void sceneC::initialise()
 {
+    // Already empty if the scene was left through switch_to_scene; this covers a direct re-entry
+    this->state.arena.reset();
+
     dialogue_count = 7;
     next_scene_id = 3; //scene_d, end of dialogue
 
 
-    GLuint map_texture_id = Utility::load_texture("assets/sceneC_tiles.png");
-    this->state.map = new Map(LEVEL_WIDTH, LEVEL_HEIGHT, sceneC_DATA, map_texture_id, 1.0f, 7, 1);
+    GLuint map_texture_id = this->load_texture("assets/sceneC_tiles.png");
+    this->state.map = state.arena.create<Map>(sceneC_LEVEL, map_texture_id, 1.0f, 1);
 
     // Code from main.cpp's initialise()
     /**
      George's Stuff
      */
      // Existing
-    state.player = new Entity();
+    state.player = state.arena.create<Entity>();
     state.player->set_entity_type(PLAYER);
     state.player->set_position(glm::vec3(2.0f, -3.0f, 0.0f));
     state.player->set_movement(glm::vec3(0.0f));
     state.player->set_orientation(glm::vec3(1.0f, 0.0f, 0.0f));
     state.player->speed = 2.5f;
     state.player->set_acceleration(glm::vec3(0.0f, 0.0f, 0.0f));
-    state.player->texture_id = Utility::load_texture("assets/geralt_new.png");
+    state.player->texture_id = this->load_texture("assets/geralt_new.png");
 
     // Walking
-    state.player->walking[state.player->LEFT] = new int[4]{ 1, 5, 9,  13 };
-    state.player->walking[state.player->RIGHT] = new int[4]{ 3, 7, 11, 15 };
-    state.player->walking[state.player->UP] = new int[4]{ 2, 6, 10, 14 };
-    state.player->walking[state.player->DOWN] = new int[4]{ 0, 4, 8,  12 };
+    state.player->walking[state.player->LEFT] = state.arena.ints({ 1, 5, 9,  13 });
+    state.player->walking[state.player->RIGHT] = state.arena.ints({ 3, 7, 11, 15 });
+    state.player->walking[state.player->UP] = state.arena.ints({ 2, 6, 10, 14 });
+    state.player->walking[state.player->DOWN] = state.arena.ints({ 0, 4, 8,  12 });
     // Attacking
-    state.player->attacking[state.player->LEFT] = new int[4]{ 17, 21, 25, 29 };
-    state.player->attacking[state.player->RIGHT] = new int[4]{ 19, 23, 27, 31 };
-    state.player->attacking[state.player->UP] = new int[4]{ 18, 22, 26, 30 };
-    state.player->attacking[state.player->DOWN] = new int[4]{ 20, 24, 28, 32 };
+    state.player->attacking[state.player->LEFT] = state.arena.ints({ 17, 21, 25, 29 });
+    state.player->attacking[state.player->RIGHT] = state.arena.ints({ 19, 23, 27, 31 });
+    state.player->attacking[state.player->UP] = state.arena.ints({ 18, 22, 26, 30 });
+    state.player->attacking[state.player->DOWN] = state.arena.ints({ 20, 24, 28, 32 });
 
     state.player->animation_indices = state.player->walking[state.player->DOWN];  // start George looking left
     state.player->animation_frames = 4;
@@ -73,8 +76,8 @@ void sceneC::initialise()
     state.player->set_attack_strength(100);
     state.player->set_attack_range(0.75f);
 
-    GLuint enemy_texture_id = Utility::load_texture("assets/foltest.png");
-    state.enemies = new Entity[this->ENEMY_COUNT];
+    GLuint enemy_texture_id = this->load_texture("assets/foltest.png");
+    state.enemies = state.arena.create_array<Entity>(this->ENEMY_COUNT);
     state.enemies[0].set_entity_type(ENEMY);
     state.enemies[0].set_ai_type(WALKER);
     state.enemies[0].set_ai_state(IDLE);
@@ -85,29 +88,53 @@ void sceneC::initialise()
     state.enemies[0].set_acceleration(glm::vec3(0.0f, 0.0f, 0.0f));
     state.enemies[0].set_hostile(false);
 
+    // AI
+    state.ai.clear();
+    state.ai.build(state.map);
+    for (int i = 0; i < ENEMY_COUNT; i++) state.ai.add(&state.enemies[i]);
+
+    // Pathfinding
+    state.paths.build(state.map);
+    for (int i = 0; i < ENEMY_COUNT; i++) state.enemies[i].pathfinder = &state.paths;
+
+    // Visibility
+    state.visibility.clear();
+    state.visibility.build(state.map);
+    for (int i = 0; i < ENEMY_COUNT; i++) state.visibility.add(&state.enemies[i]);
+
+    // Animation
+    state.animations.clear();
+    state.animations.add(state.player);
+    for (int i = 0; i < ENEMY_COUNT; i++) state.animations.add(&state.enemies[i]);
+
+    // Events
+    state.events.clear();
+    state.events.attach(state.player);
+    for (int i = 0; i < ENEMY_COUNT; i++) state.events.attach(&state.enemies[i]);
+
     /**
      BGM and SFX
      */
     Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 4096);
 
-    state.bgm = Mix_LoadMUS("assets/eve.mp3");
+    state.bgm = this->load_music("assets/eve.mp3");
     Mix_PlayMusic(state.bgm, -1);
     Mix_VolumeMusic(4.0f);
 }
 
 void sceneC::update(float delta_time)
 {
-    this->state.player->update(delta_time, state.player, state.enemies, this->ENEMY_COUNT, this->state.map);
-    for (int i = 0; i < ENEMY_COUNT; i++) this->state.enemies[i].update(delta_time, state.player, NULL, 0, this->state.map);
+    this->update_entities(delta_time, ENEMY_COUNT);
 }
 
 void sceneC::render(ShaderProgram* program)
 {
     this->state.map->render(program);
     this->state.player->render(program);
+    this->state.visibility.cull(this->state.camera);
+    this->state.visibility.render(program);
     for (int i = 0; i < ENEMY_COUNT; i++)
     {
-        if (this->state.enemies[i].get_active_state()) state.enemies[i].render(program);
         if (!this->state.enemies[i].hostile && this->state.enemies[i].speaking)
         {
             cutscene = true;
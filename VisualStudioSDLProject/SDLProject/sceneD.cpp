@@ -2,6 +2,7 @@
 // ADDITION: add logo. so far its just char
 #include "sceneD.h"
 #include "Utility.h"
+#include "StaticLevel.h"
 
 #define LEVEL_WIDTH 14
 #define LEVEL_HEIGHT 8
@@ -9,7 +10,7 @@
 // Font
 
 
-unsigned int sceneD_DATA[] =
+constexpr unsigned int sceneD_DATA[] =
 {
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -21,41 +22,46 @@ unsigned int sceneD_DATA[] =
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
 };
 
+// Texels, merged runs and collision bits, all worked out by the compiler
+constexpr StaticLevel<LEVEL_WIDTH, LEVEL_HEIGHT, 4> sceneD_LEVEL(sceneD_DATA);
+
 sceneD::~sceneD()
 {
-    delete    this->state.player;
-    delete    this->state.map;
-    Mix_FreeMusic(this->state.bgm);
+    this->state.arena.reset();
 }
 
 void sceneD::initialise()
 {
+    // Already empty if the scene was left through switch_to_scene; this covers a direct re-entry
+    this->state.arena.reset();
+
     cutscene = true;
+    idle = true;
     next_scene_id = 4; //scene_b, enter
 
 
-    GLuint map_texture_id = Utility::load_texture("assets/tileset.png");
-    this->state.map = new Map(LEVEL_WIDTH, LEVEL_HEIGHT, sceneD_DATA, map_texture_id, 1.0f, 4, 1);
+    GLuint map_texture_id = this->load_texture("assets/tileset.png");
+    this->state.map = state.arena.create<Map>(sceneD_LEVEL, map_texture_id, 1.0f, 1);
 
-    state.player = new Entity();
+    state.player = state.arena.create<Entity>();
     state.player->set_entity_type(PLAYER);
     state.player->set_position(glm::vec3(5.0f, -3.75f, 0.0f));
     state.player->set_movement(glm::vec3(0.0f));
     state.player->set_orientation(glm::vec3(1.0f, 0.0f, 0.0f));
     state.player->speed = 2.5f;
     state.player->set_acceleration(glm::vec3(0.0f, 0.0f, 0.0f));
-    state.player->texture_id = Utility::load_texture("assets/geralt_new.png");
+    state.player->texture_id = this->load_texture("assets/geralt_new.png");
 
     // Walking
-    state.player->walking[state.player->LEFT] = new int[4]{ 1, 5, 9,  13 };
-    state.player->walking[state.player->RIGHT] = new int[4]{ 3, 7, 11, 15 };
-    state.player->walking[state.player->UP] = new int[4]{ 2, 6, 10, 14 };
-    state.player->walking[state.player->DOWN] = new int[4]{ 0, 4, 8,  12 };
+    state.player->walking[state.player->LEFT] = state.arena.ints({ 1, 5, 9,  13 });
+    state.player->walking[state.player->RIGHT] = state.arena.ints({ 3, 7, 11, 15 });
+    state.player->walking[state.player->UP] = state.arena.ints({ 2, 6, 10, 14 });
+    state.player->walking[state.player->DOWN] = state.arena.ints({ 0, 4, 8,  12 });
     // Attacking
-    state.player->attacking[state.player->LEFT] = new int[4]{ 17, 21, 25, 29 };
-    state.player->attacking[state.player->RIGHT] = new int[4]{ 19, 23, 27, 31 };
-    state.player->attacking[state.player->UP] = new int[4]{ 18, 22, 26, 30 };
-    state.player->attacking[state.player->DOWN] = new int[4]{ 20, 24, 28, 32 };
+    state.player->attacking[state.player->LEFT] = state.arena.ints({ 17, 21, 25, 29 });
+    state.player->attacking[state.player->RIGHT] = state.arena.ints({ 19, 23, 27, 31 });
+    state.player->attacking[state.player->UP] = state.arena.ints({ 18, 22, 26, 30 });
+    state.player->attacking[state.player->DOWN] = state.arena.ints({ 20, 24, 28, 32 });
 
     state.player->animation_indices = state.player->walking[state.player->DOWN];  // start George looking left
     state.player->animation_frames = 4;
@@ -70,12 +76,22 @@ void sceneD::initialise()
     state.player->set_attack_range(0.75f);
     // ADDITION: reorganize each level so that these are not set unneccessarily
 
+    // Animation
+    state.animations.clear();
+    state.animations.add(state.player);
+    for (int i = 0; i < ENEMY_COUNT; i++) state.animations.add(&state.enemies[i]);
+
+    // Events
+    state.events.clear();
+    state.events.attach(state.player);
+    for (int i = 0; i < ENEMY_COUNT; i++) state.events.attach(&state.enemies[i]);
+
     /**
      BGM and SFX
      */
     Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 4096);
 
-    state.bgm = Mix_LoadMUS("assets/tgate.mp3");
+    state.bgm = this->load_music("assets/tgate.mp3");
     Mix_PlayMusic(state.bgm, -1);
     Mix_VolumeMusic(4.0f);
 }
@@ -83,6 +99,8 @@ void sceneD::initialise()
 void sceneD::update(float delta_time)
 {
     this->state.player->update(delta_time, state.player, state.enemies, this->ENEMY_COUNT, this->state.map);
+    this->state.animations.advance(delta_time);
+    this->state.events.resolve();
 }
 
 void sceneD::render(ShaderProgram* program)
@@ -2,11 +2,12 @@
 // ADDITION: make player a parameter passed in each scene so that decisions, health, inventories in the future will be kept track
 #include "sceneE.h"
 #include "Utility.h"
+#include "StaticLevel.h"
 
 #define LEVEL_WIDTH 14
 #define LEVEL_HEIGHT 8
 
-unsigned int sceneE_DATA[] =
+constexpr unsigned int sceneE_DATA[] =
 {
     1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
     2, 0, 0, 0, 0, 3, 0, 5, 0, 0, 0, 0, 4, 2,
@@ -18,48 +19,50 @@ unsigned int sceneE_DATA[] =
     2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2, 2
 };
 
+// Texels, merged runs and collision bits, all worked out by the compiler
+constexpr StaticLevel<LEVEL_WIDTH, LEVEL_HEIGHT, 8> sceneE_LEVEL(sceneE_DATA);
+
 sceneE::~sceneE()
 {
-    delete[] this->state.enemies;
-    delete    this->state.player;
-    delete    this->state.map;
-    Mix_FreeChunk(this->state.jump_sfx);
-    Mix_FreeMusic(this->state.bgm);
+    this->state.arena.reset();
 }
 
 void sceneE::initialise()
 {
+    // Already empty if the scene was left through switch_to_scene; this covers a direct re-entry
+    this->state.arena.reset();
+
     dialogue_count = 8;
     next_scene_id = 5; //scene_f, if decide 1 then game ends, if not beat ostrit and go to right
 
 
-    GLuint map_texture_id = Utility::load_texture("assets/sceneE_tiles.png");
-    this->state.map = new Map(LEVEL_WIDTH, LEVEL_HEIGHT, sceneE_DATA, map_texture_id, 1.0f, 8, 1);
+    GLuint map_texture_id = this->load_texture("assets/sceneE_tiles.png");
+    this->state.map = state.arena.create<Map>(sceneE_LEVEL, map_texture_id, 1.0f, 1);
 
     // Code from main.cpp's initialise()
     /**
      George's Stuff
      */
      // Existing
-    state.player = new Entity();
+    state.player = state.arena.create<Entity>();
     state.player->set_entity_type(PLAYER);
     state.player->set_position(glm::vec3(2.0f, -3.0f, 0.0f));
     state.player->set_movement(glm::vec3(0.0f));
     state.player->set_orientation(glm::vec3(1.0f, 0.0f, 0.0f));
     state.player->speed = 2.5f;
     state.player->set_acceleration(glm::vec3(0.0f, 0.0f, 0.0f));
-    state.player->texture_id = Utility::load_texture("assets/geralt_new.png");
+    state.player->texture_id = this->load_texture("assets/geralt_new.png");
 
     // Walking
-    state.player->walking[state.player->LEFT] = new int[4]{ 1, 5, 9,  13 };
-    state.player->walking[state.player->RIGHT] = new int[4]{ 3, 7, 11, 15 };
-    state.player->walking[state.player->UP] = new int[4]{ 2, 6, 10, 14 };
-    state.player->walking[state.player->DOWN] = new int[4]{ 0, 4, 8,  12 };
+    state.player->walking[state.player->LEFT] = state.arena.ints({ 1, 5, 9,  13 });
+    state.player->walking[state.player->RIGHT] = state.arena.ints({ 3, 7, 11, 15 });
+    state.player->walking[state.player->UP] = state.arena.ints({ 2, 6, 10, 14 });
+    state.player->walking[state.player->DOWN] = state.arena.ints({ 0, 4, 8,  12 });
     // Attacking
-    state.player->attacking[state.player->LEFT] = new int[4]{ 17, 21, 25, 29 };
-    state.player->attacking[state.player->RIGHT] = new int[4]{ 19, 23, 27, 31 };
-    state.player->attacking[state.player->UP] = new int[4]{ 18, 22, 26, 30 };
-    state.player->attacking[state.player->DOWN] = new int[4]{ 20, 24, 28, 32 };
+    state.player->attacking[state.player->LEFT] = state.arena.ints({ 17, 21, 25, 29 });
+    state.player->attacking[state.player->RIGHT] = state.arena.ints({ 19, 23, 27, 31 });
+    state.player->attacking[state.player->UP] = state.arena.ints({ 18, 22, 26, 30 });
+    state.player->attacking[state.player->DOWN] = state.arena.ints({ 20, 24, 28, 32 });
 
     state.player->animation_indices = state.player->walking[state.player->DOWN];  // start George looking left
     state.player->animation_frames = 4;
@@ -74,8 +77,8 @@ void sceneE::initialise()
     state.player->set_attack_strength(100);
     state.player->set_attack_range(0.75f);
 
-    GLuint enemy_texture_id = Utility::load_texture("assets/ostrit.png");
-    state.enemies = new Entity[this->ENEMY_COUNT];
+    GLuint enemy_texture_id = this->load_texture("assets/ostrit.png");
+    state.enemies = state.arena.create_array<Entity>(this->ENEMY_COUNT);
     state.enemies[0].set_entity_type(ENEMY);
     state.enemies[0].set_ai_type(GUARD);
     state.enemies[0].set_ai_state(IDLE);
@@ -88,10 +91,10 @@ void sceneE::initialise()
     state.enemies[0].set_attack_strength(20);
 
     // Walking
-    state.enemies[0].walking[state.player->LEFT] = new int[4]{ 1, 5, 9,  13 };
-    state.enemies[0].walking[state.player->RIGHT] = new int[4]{ 3, 7, 11, 15 };
-    state.enemies[0].walking[state.player->UP] = new int[4]{ 2, 6, 10, 14 };
-    state.enemies[0].walking[state.player->DOWN] = new int[4]{ 0, 4, 8,  12 };
+    state.enemies[0].walking[state.player->LEFT] = state.arena.ints({ 1, 5, 9,  13 });
+    state.enemies[0].walking[state.player->RIGHT] = state.arena.ints({ 3, 7, 11, 15 });
+    state.enemies[0].walking[state.player->UP] = state.arena.ints({ 2, 6, 10, 14 });
+    state.enemies[0].walking[state.player->DOWN] = state.arena.ints({ 0, 4, 8,  12 });
 
     state.enemies[0].animation_indices = state.player->walking[state.player->LEFT];  // start George looking left
     state.enemies[0].animation_frames = 4;
@@ -100,6 +103,30 @@ void sceneE::initialise()
     state.enemies[0].animation_cols = 4;
     state.enemies[0].animation_rows = 4;
 
+    // AI
+    state.ai.clear();
+    state.ai.build(state.map);
+    for (int i = 0; i < ENEMY_COUNT; i++) state.ai.add(&state.enemies[i]);
+
+    // Pathfinding
+    state.paths.build(state.map);
+    for (int i = 0; i < ENEMY_COUNT; i++) state.enemies[i].pathfinder = &state.paths;
+
+    // Visibility
+    state.visibility.clear();
+    state.visibility.build(state.map);
+    for (int i = 0; i < ENEMY_COUNT; i++) state.visibility.add(&state.enemies[i]);
+
+    // Animation
+    state.animations.clear();
+    state.animations.add(state.player);
+    for (int i = 0; i < ENEMY_COUNT; i++) state.animations.add(&state.enemies[i]);
+
+    // Events
+    state.events.clear();
+    state.events.attach(state.player);
+    for (int i = 0; i < ENEMY_COUNT; i++) state.events.attach(&state.enemies[i]);
+
     /**
      BGM and SFX
      */
@@ -108,19 +135,35 @@ void sceneE::initialise()
 
 void sceneE::update(float delta_time)
 {
-    this->state.player->update(delta_time, state.player, state.enemies, this->ENEMY_COUNT, this->state.map);
-    for (int i = 0; i < ENEMY_COUNT; i++) this->state.enemies[i].update(delta_time, state.player, NULL, 0, this->state.map);
+    this->update_entities(delta_time, ENEMY_COUNT);
     if (this->state.player->get_position().x > 11.0f && this->state.player->get_position().y < -4.0f) completed = true;
 }
 
+void sceneE::plan_retreat(Entity *guard)
+{
+    int tile_x, tile_y;
+    if (!this->state.map->get_tile_coordinates(guard->get_position(), &tile_x, &tile_y)) return;
+    
+    // The rightmost open tile in the guard's row; without a route it keeps the old straight walk
+    int retreat_x = this->state.map->get_width() - 1;
+    while (retreat_x > tile_x && this->state.map->is_solid_tile(retreat_x, tile_y)) retreat_x--;
+    
+    guard->route_step = 0;
+    if (!this->state.paths.find_path(guard->get_position(), this->state.map->get_tile_center(retreat_x, tile_y), guard->route))
+    {
+        guard->route.clear();
+    }
+}
+
 void sceneE::render(ShaderProgram* program)
 {
     this->state.map->render(program);
     this->state.player->render(program);
+    this->state.visibility.cull(this->state.camera);
+    this->state.visibility.render(program);
     if (state.player->get_position().x > 11.0f && this->state.player->get_position().y > -2.0f) { Utility::draw_text(program, "silksong when?", 0.75f, -0.45f, glm::vec3(3.75f, -5.0f, 0.0f)); }
     for (int i = 0; i < ENEMY_COUNT; i++)
     {
-        if (this->state.enemies[i].get_active_state()) state.enemies[i].render(program);
         if (!this->state.enemies[i].hostile && this->state.enemies[i].speaking)
         {
             cutscene = true;
@@ -147,6 +190,7 @@ void sceneE::render(ShaderProgram* program)
                 Utility::draw_text(program, "to leave it be, yes? (y)", 0.75f, -0.45f, glm::vec3(3.75f, -5.0f, 0.0f));
                 break;
             case 1:
+                if (this->state.enemies[i].get_ai_state() != BACK_AWAY) this->plan_retreat(&this->state.enemies[i]);
                 this->state.enemies[i].set_ai_state(BACK_AWAY);
                 Utility::draw_text(program, "then DIE!", 0.75f, -0.45f, glm::vec3(3.75f, -5.0f, 0.0f));
                 break;
@@ -9,4 +9,7 @@ public:
     void initialise() override;
     void update(float delta_time) override;
     void render(ShaderProgram* program) override;
+    
+    // Routes the guard to the far right of its row, around anything in the way
+    void plan_retreat(Entity *guard);
 };
\ No newline at end of file
@@ -0,0 +1,45 @@
+#define MAX_LAYERS 8           // keep in step with MAP_MAX_LAYERS
+#define NO_TILE 65535.0        // MAP_NO_TILE: nothing drawn there on this layer
+
+uniform sampler2D diffuse;     // the tileset, shared by every layer
+uniform sampler2D tileIndices; // one texel per tile, layers stacked top to bottom: index low byte in red, high byte in green
+uniform vec2 mapSize;          // in tiles, one layer's worth
+uniform vec2 tilesetSize;      // tiles across and down the tileset
+
+uniform float layerCount;      // layers stacked in tileIndices
+uniform float firstLayer;      // the range this draw composites, back to front
+uniform float lastLayer;
+uniform float parallax[MAX_LAYERS];
+uniform vec2 cameraOffset;     // camera from the map's centre, in tiles, y down
+
+varying vec2 texCoordVar;      // map position in tiles, from the top-left corner, y down
+
+void main() {
+    vec4 color = vec4(0.0);
+
+    for (int i = 0; i < MAX_LAYERS; i++)
+    {
+        float layer = float(i);
+        if (layer < firstLayer || layer > lastLayer) continue;
+
+        // A layer scrolling at a fraction of the camera's speed lags behind it by the rest
+        vec2 position = texCoordVar - cameraOffset * (1.0 - parallax[i]);
+        if (position.x < 0.0 || position.y < 0.0 || position.x >= mapSize.x || position.y >= mapSize.y) continue;
+
+        vec2 tile = floor(position);
+        vec2 row = vec2(tile.x, tile.y + layer * mapSize.y);
+        vec4 texel = texture2D(tileIndices, (row + 0.5) / vec2(mapSize.x, mapSize.y * layerCount));
+        float index = floor(texel.r * 255.0 + 0.5) + floor(texel.g * 255.0 + 0.5) * 256.0;
+        if (index == NO_TILE) continue;
+
+        vec2 cell = vec2(mod(index, tilesetSize.x), floor(index / tilesetSize.x));
+        vec4 tileColor = texture2D(diffuse, (cell + fract(position)) / tilesetSize);
+
+        // Over, kept unpremultiplied so a single layer comes out exactly as its tile
+        float alpha = tileColor.a + color.a * (1.0 - tileColor.a);
+        if (alpha > 0.0) color.rgb = (tileColor.rgb * tileColor.a + color.rgb * color.a * (1.0 - tileColor.a)) / alpha;
+        color.a = alpha;
+    }
+
+    gl_FragColor = color;
+}
@@ -0,0 +1,10 @@
+uniform sampler2D diffuse;
+uniform vec2 tilesetSize;  // tiles across and down the tileset
+
+varying vec2 texCoordVar;
+varying vec2 tileOffsetVar;
+
+void main() {
+    // Wrapping by hand: the tileset is an atlas, so GL_REPEAT would run into the neighbouring cells
+    gl_FragColor = texture2D(diffuse, (tileOffsetVar + fract(texCoordVar)) / tilesetSize);
+}
@@ -0,0 +1,18 @@
+attribute vec4 position;
+attribute vec2 texCoord;   // position inside the run, in tiles; runs past 1.0 where it repeats
+attribute vec2 tileOffset; // which tileset cell the whole run shows
+
+uniform mat4 modelMatrix;
+uniform mat4 viewMatrix;
+uniform mat4 projectionMatrix;
+
+varying vec2 texCoordVar;
+varying vec2 tileOffsetVar;
+
+void main()
+{
+	vec4 p = viewMatrix * modelMatrix  * position;
+    texCoordVar = texCoord;
+    tileOffsetVar = tileOffset;
+	gl_Position = projectionMatrix * p;
+}
@@ -15,9 +15,9 @@
 
 Entity::Entity()
 {
-    position     = glm::vec3(0.0f);
-    velocity     = glm::vec3(0.0f);
-    acceleration = glm::vec3(0.0f);
+    position     = physics_vec3(glm::vec3(0.0f));
+    velocity     = physics_vec3(glm::vec3(0.0f));
+    acceleration = physics_vec3(glm::vec3(0.0f));
     
     movement = glm::vec3(0.0f);
     
@@ -102,16 +102,19 @@ void Entity::update(float delta_time, Entity *collidable_entities, int collidabl
         }
     }
     
+    // Converted once so every product below stays in the physics scalar
+    physics_scalar step = delta_time;
+    
     // Our character moves from left to right, so they need an initial velocity
     acceleration.x = movement.x * speed;
     
     // Now we add the rest of the gravity physics
-    velocity += acceleration * delta_time;
+    velocity += acceleration * step;
     
-    position.y += velocity.y * delta_time;
+    position.y += velocity.y * step;
     check_collision_y(collidable_entities, collidable_entity_count); // exclude the winning collision
     
-    position.x += velocity.x * delta_time;
+    position.x += velocity.x * step;
     check_collision_x(collidable_entities, collidable_entity_count); // exclude the winning collision
     
     // Jump, don't need
@@ -126,7 +129,7 @@ void Entity::update(float delta_time, Entity *collidable_entities, int collidabl
     }
     */
     model_matrix = glm::mat4(1.0f);
-    model_matrix = glm::translate(model_matrix, position);
+    model_matrix = glm::translate(model_matrix, get_position());
 }
 
 
@@ -138,8 +141,8 @@ void const Entity::check_collision_y(Entity *collidable_entities, int collidable
         
         if (check_collision(collidable_entity))
         {
-            float y_distance = fabs(position.y - collidable_entity->position.y);
-            float y_overlap = fabs(y_distance - (height / 2.0f) - (collidable_entity->height / 2.0f));
+            physics_scalar y_distance = fabs(position.y - collidable_entity->position.y);
+            physics_scalar y_overlap = fabs(y_distance - (height / 2.0f) - (collidable_entity->height / 2.0f));
             if (velocity.y > 0) {
                 position.y   -= y_overlap;
                 velocity.y    = 0;
@@ -164,8 +167,8 @@ void const Entity::check_collision_x(Entity *collidable_entities, int collidable
         
         if (check_collision(collidable_entity))
         {
-            float x_distance = fabs(position.x - collidable_entity->position.x);
-            float x_overlap = fabs(x_distance - (width / 2.0f) - (collidable_entity->width / 2.0f));
+            physics_scalar x_distance = fabs(position.x - collidable_entity->position.x);
+            physics_scalar x_overlap = fabs(x_distance - (width / 2.0f) - (collidable_entity->width / 2.0f));
             if (velocity.x > 0) {
                 position.x     -= x_overlap;
                 velocity.x      = 0;
@@ -212,8 +215,8 @@ bool const Entity::check_collision(Entity *other) const
     // If either entity is inactive, there shouldn't be any collision
     if (!is_active || !other->is_active) return false;
     
-    float x_distance = fabs(position.x - other->position.x) - ((width  + other->width)  / 2.0f);
-    float y_distance = fabs(position.y - other->position.y) - ((height + other->height) / 2.0f);
+    physics_scalar x_distance = fabs(position.x - other->position.x) - ((width  + other->width)  / 2.0f);
+    physics_scalar y_distance = fabs(position.y - other->position.y) - ((height + other->height) / 2.0f);
     
     return x_distance < 0.0f && y_distance < 0.0f;
 }
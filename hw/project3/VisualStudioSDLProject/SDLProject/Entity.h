@@ -1,3 +1,6 @@
+#pragma once
+#include "Physics.h"
+
 enum EntityType { PLATFORM, PLAYER, ITEM };
 
 class Entity
@@ -10,12 +13,13 @@ private:
     int *animation_up    = NULL; // move upwards
     int *animation_down  = NULL; // move downwards
     
-    glm::vec3 position;
-    glm::vec3 velocity;
-    glm::vec3 acceleration;
+    // Physics state lives in physics_scalar (float, or Q16.16 under PHYSICS_FIXED_POINT)
+    physics_vec3 position;
+    physics_vec3 velocity;
+    physics_vec3 acceleration;
     
-    float width  = 1;
-    float height = 1;
+    physics_scalar width  = 1;
+    physics_scalar height = 1;
     
 public:
     // Static attributes
@@ -68,17 +72,17 @@ public:
     void activate()   { is_active = true;  };
     void deactivate() { is_active = false; };
     
-    glm::vec3 const get_position()     const { return position;     };
-    glm::vec3 const get_movement()     const { return movement;     };
-    glm::vec3 const get_velocity()     const { return velocity;     };
-    glm::vec3 const get_acceleration() const { return acceleration; };
-    int       const get_width()        const { return width;        };
-    int       const get_height()       const { return height;       };
+    glm::vec3 const get_position()     const { return to_vec3(position);     };
+    glm::vec3 const get_movement()     const { return movement;              };
+    glm::vec3 const get_velocity()     const { return to_vec3(velocity);     };
+    glm::vec3 const get_acceleration() const { return to_vec3(acceleration); };
+    int       const get_width()        const { return (int) width;           };
+    int       const get_height()       const { return (int) height;          };
     
-    void const set_position(glm::vec3 new_position)         { position = new_position;         };
-    void const set_movement(glm::vec3 new_movement)         { movement = new_movement;         };
-    void const set_velocity(glm::vec3 new_velocity)         { velocity = new_velocity;         };
-    void const set_acceleration(glm::vec3 new_acceleration) { acceleration = new_acceleration; };
+    void const set_position(glm::vec3 new_position)         { position = physics_vec3(new_position);         };
+    void const set_movement(glm::vec3 new_movement)         { movement = new_movement;                       };
+    void const set_velocity(glm::vec3 new_velocity)         { velocity = physics_vec3(new_velocity);         };
+    void const set_acceleration(glm::vec3 new_acceleration) { acceleration = physics_vec3(new_acceleration); };
     void const set_width(float new_width)                   { width = new_width;               };
     void const set_height(float new_height)                 { height = new_height;             };
 };
@@ -0,0 +1,81 @@
+#include "StaticProps.h"
+
+StaticBatch &StaticProps::get_batch(GLuint texture_id)
+{
+    for (size_t i = 0; i < batches.size(); i++)
+    {
+        if (batches[i].texture_id == texture_id) return batches[i];
+    }
+
+    StaticBatch batch;
+    batch.texture_id = texture_id;
+    batches.push_back(batch);
+
+    return batches.back();
+}
+
+void StaticProps::add(Entity *prop)
+{
+    // Same unit quad Entity::render draws, just translated here instead of through the model matrix
+    glm::vec3 position = prop->get_position();
+
+    float left   = position.x - 0.5f, right = position.x + 0.5f;
+    float bottom = position.y - 0.5f, top   = position.y + 0.5f;
+
+    StaticBatch &batch = get_batch(prop->texture_id);
+    batch.vertices.insert(batch.vertices.end(), {
+        left,  bottom, 0.0f, 1.0f,
+        right, bottom, 1.0f, 1.0f,
+        right, top,    1.0f, 0.0f,
+        left,  bottom, 0.0f, 1.0f,
+        right, top,    1.0f, 0.0f,
+        left,  top,    0.0f, 0.0f
+    });
+}
+
+void StaticProps::build()
+{
+    for (size_t i = 0; i < batches.size(); i++)
+    {
+        StaticBatch &batch = batches[i];
+        if (batch.buffer == 0) glGenBuffers(1, &batch.buffer);
+
+        glBindBuffer(GL_ARRAY_BUFFER, batch.buffer);
+        glBufferData(GL_ARRAY_BUFFER, batch.vertices.size() * sizeof(float), batch.vertices.data(), GL_STATIC_DRAW);
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void StaticProps::render(ShaderProgram *program)
+{
+    // Vertices are already in world space
+    program->SetModelMatrix(glm::mat4(1.0f));
+
+    for (size_t i = 0; i < batches.size(); i++)
+    {
+        StaticBatch &batch = batches[i];
+
+        glBindTexture(GL_TEXTURE_2D, batch.texture_id);
+        glBindBuffer(GL_ARRAY_BUFFER, batch.buffer);
+
+        glVertexAttribPointer(program->positionAttribute, 2, GL_FLOAT, false, 4 * sizeof(float), (void*) 0);
+        glEnableVertexAttribArray(program->positionAttribute);
+        glVertexAttribPointer(program->texCoordAttribute, 2, GL_FLOAT, false, 4 * sizeof(float), (void*) (2 * sizeof(float)));
+        glEnableVertexAttribArray(program->texCoordAttribute);
+
+        glDrawArrays(GL_TRIANGLES, 0, (int) batch.vertices.size() / 4);
+
+        glDisableVertexAttribArray(program->positionAttribute);
+        glDisableVertexAttribArray(program->texCoordAttribute);
+    }
+
+    // The ship and the text still draw from client-side arrays
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void StaticProps::release()
+{
+    for (size_t i = 0; i < batches.size(); i++) glDeleteBuffers(1, &batches[i].buffer);
+    batches.clear();
+}
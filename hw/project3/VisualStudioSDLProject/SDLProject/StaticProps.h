@@ -0,0 +1,42 @@
+#pragma once
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <vector>
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "ShaderProgram.h"
+#include "Entity.h"
+
+/**
+ All the quads that share a texture, already moved to where they sit in the world.
+ */
+struct StaticBatch
+{
+    GLuint texture_id;
+    std::vector<float> vertices; // x, y, u, v per vertex
+    GLuint buffer = 0;
+};
+
+/**
+ Props that never move (the platforms) are baked into one buffer per texture at load time and
+ drawn without a per-object model matrix or update.
+ */
+class StaticProps {
+private:
+    std::vector<StaticBatch> batches;
+
+    StaticBatch &get_batch(GLuint texture_id);
+
+public:
+    void add(Entity *prop);
+    void build();
+    void render(ShaderProgram *program);
+    void release();
+};
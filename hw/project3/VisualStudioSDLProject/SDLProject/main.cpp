@@ -3,6 +3,8 @@
 #define LOG(argument) std::cout << argument << '\n'
 #define GL_GLEXT_PROTOTYPES 1
 #define FIXED_TIMESTEP 0.0166666f
+#define FRAME_PACING_MODE VSYNC_PACING
+#define FRAME_RATE_CAP 60.0f // capped and on-demand pacing only
 #define PLATFORM_COUNT 5
 
 #ifdef _WINDOWS
@@ -14,19 +16,33 @@
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 #include "ShaderProgram.h"
+#include "FramePacer.h"
 #include "stb_image.h"
 #include "cmath"
 #include <ctime>
+#include <string>
 #include <vector>
 #include "Entity.h"
+#include "StaticProps.h"
 
 /**
  STRUCTS AND ENUMS
  */
+struct CachedText
+{
+    std::string key;
+    GLuint buffer = 0;
+    int vertex_count = 0;
+};
+
 struct GameState
 {
     Entity* player;
-    Entity* platforms;
+    Entity* platforms;    // collision only; drawn through static_props
+    StaticProps static_props;
+
+    GLuint font_texture_id = 0;
+    std::vector<CachedText> text_cache; // one buffer per distinct string, built the first time it's drawn
 };
 
 /**
@@ -112,64 +128,80 @@ GLuint load_texture(const char* filepath)
 
 void DrawText(ShaderProgram* program, GLuint font_texture_id, std::string text, float screen_size, float spacing, glm::vec3 position)
 {
-    // Scale the size of the fontbank in the UV-plane
-    // We will use this for spacing and positioning
-    float width = 1.0f / FONTBANK_SIZE;
-    float height = 1.0f / FONTBANK_SIZE;
-
-    // Instead of having a single pair of arrays, we'll have a series of pairsone for each character
-    // Don't forget to include <vector>!
-    std::vector<float> vertices;
-    std::vector<float> texture_coordinates;
-
-    // For every character...
-    for (int i = 0; i < text.size(); i++) {
-        // 1. Get their index in the spritesheet, as well as their offset (i.e. their position
-        //    relative to the whole sentence)
-        int spritesheet_index = (int)text[i];  // ascii value of character
-        float offset = (screen_size + spacing) * i;
-
-        // 2. Using the spritesheet index, we can calculate our U- and V-coordinates
-        float u_coordinate = (float)(spritesheet_index % FONTBANK_SIZE) / FONTBANK_SIZE;
-        float v_coordinate = (float)(spritesheet_index / FONTBANK_SIZE) / FONTBANK_SIZE;
-
-        // 3. Inset the current pair in both vectors
-        vertices.insert(vertices.end(), {
-            offset + (-0.5f * screen_size), 0.5f * screen_size,
-            offset + (-0.5f * screen_size), -0.5f * screen_size,
-            offset + (0.5f * screen_size), 0.5f * screen_size,
-            offset + (0.5f * screen_size), -0.5f * screen_size,
-            offset + (0.5f * screen_size), 0.5f * screen_size,
-            offset + (-0.5f * screen_size), -0.5f * screen_size,
-            });
-
-        texture_coordinates.insert(texture_coordinates.end(), {
-            u_coordinate, v_coordinate,
-            u_coordinate, v_coordinate + height,
-            u_coordinate + width, v_coordinate,
-            u_coordinate + width, v_coordinate + height,
-            u_coordinate + width, v_coordinate,
-            u_coordinate, v_coordinate + height,
-            });
+    // The lander only ever shows a handful of fixed strings, so each one is laid out once and kept in
+    // a buffer instead of being rebuilt every frame
+    std::string key = std::to_string(screen_size) + ',' + std::to_string(spacing) + ',' + text;
+
+    CachedText* cached = NULL;
+    for (size_t i = 0; i < state.text_cache.size(); i++)
+    {
+        if (state.text_cache[i].key == key) cached = &state.text_cache[i];
+    }
+
+    if (cached == NULL)
+    {
+        // Scale the size of the fontbank in the UV-plane
+        // We will use this for spacing and positioning
+        float width = 1.0f / FONTBANK_SIZE;
+        float height = 1.0f / FONTBANK_SIZE;
+
+        std::vector<float> vertices; // x, y, u, v per vertex
+
+        // For every character...
+        for (int i = 0; i < text.size(); i++) {
+            // 1. Get their index in the spritesheet, as well as their offset (i.e. their position
+            //    relative to the whole sentence)
+            int spritesheet_index = (int)text[i];  // ascii value of character
+            float offset = (screen_size + spacing) * i;
+
+            // 2. Using the spritesheet index, we can calculate our U- and V-coordinates
+            float u_coordinate = (float)(spritesheet_index % FONTBANK_SIZE) / FONTBANK_SIZE;
+            float v_coordinate = (float)(spritesheet_index / FONTBANK_SIZE) / FONTBANK_SIZE;
+
+            // 3. Add the character's two triangles
+            vertices.insert(vertices.end(), {
+                offset + (-0.5f * screen_size), 0.5f * screen_size,  u_coordinate,         v_coordinate,
+                offset + (-0.5f * screen_size), -0.5f * screen_size, u_coordinate,         v_coordinate + height,
+                offset + (0.5f * screen_size), 0.5f * screen_size,   u_coordinate + width, v_coordinate,
+                offset + (0.5f * screen_size), -0.5f * screen_size,  u_coordinate + width, v_coordinate + height,
+                offset + (0.5f * screen_size), 0.5f * screen_size,   u_coordinate + width, v_coordinate,
+                offset + (-0.5f * screen_size), -0.5f * screen_size, u_coordinate,         v_coordinate + height,
+                });
+        }
+
+        CachedText new_text;
+        new_text.key = key;
+        new_text.vertex_count = (int)(vertices.size() / 4);
+
+        glGenBuffers(1, &new_text.buffer);
+        glBindBuffer(GL_ARRAY_BUFFER, new_text.buffer);
+        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+
+        state.text_cache.push_back(new_text);
+        cached = &state.text_cache.back();
     }
 
-    // 4. And render all of them using the pairs
+    // 4. And render all of them from the buffer
     glm::mat4 model_matrix = glm::mat4(1.0f);
     model_matrix = glm::translate(model_matrix, position);
 
     program->SetModelMatrix(model_matrix);
     glUseProgram(program->programID);
 
-    glVertexAttribPointer(program->positionAttribute, 2, GL_FLOAT, false, 0, vertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, cached->buffer);
+    glVertexAttribPointer(program->positionAttribute, 2, GL_FLOAT, false, 4 * sizeof(float), (void*) 0);
     glEnableVertexAttribArray(program->positionAttribute);
-    glVertexAttribPointer(program->texCoordAttribute, 2, GL_FLOAT, false, 0, texture_coordinates.data());
+    glVertexAttribPointer(program->texCoordAttribute, 2, GL_FLOAT, false, 4 * sizeof(float), (void*) (2 * sizeof(float)));
     glEnableVertexAttribArray(program->texCoordAttribute);
 
     glBindTexture(GL_TEXTURE_2D, font_texture_id);
-    glDrawArrays(GL_TRIANGLES, 0, (int)(text.size() * 6));
+    glDrawArrays(GL_TRIANGLES, 0, cached->vertex_count);
 
     glDisableVertexAttribArray(program->positionAttribute);
     glDisableVertexAttribArray(program->texCoordAttribute);
+
+    // The ship still draws from client-side arrays
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void initialise()
@@ -210,21 +242,22 @@ void initialise()
     state.platforms[PLATFORM_COUNT - 1].texture_id = target_texture_id;
     state.platforms[PLATFORM_COUNT - 1].set_position(glm::vec3(-1.5f, -2.35f, 0.0f));
     state.platforms[PLATFORM_COUNT - 1].set_width(0.4f);
-    state.platforms[PLATFORM_COUNT - 1].update(0.0f, NULL, 0);
 
     state.platforms[PLATFORM_COUNT - 2].texture_id = platform_texture_id;
     state.platforms[PLATFORM_COUNT - 2].set_position(glm::vec3(2.5f, -2.5f, 0.0f));
     state.platforms[PLATFORM_COUNT - 2].set_width(0.4f);
-    state.platforms[PLATFORM_COUNT - 2].update(0.0f, NULL, 0);
     
     for (int i = 0; i < PLATFORM_COUNT - 2; i++)
     {
         state.platforms[i].texture_id = platform_texture_id;
         state.platforms[i].set_position(glm::vec3(i - 1.0f, 1.0f, 0.0f));
         state.platforms[i].set_width(0.4f);
-        state.platforms[i].update(0.0f, NULL, 0);
     }
     
+    // Platforms never move, so bake them once instead of updating and drawing each one
+    for (int i = 0; i < PLATFORM_COUNT; i++) state.static_props.add(&state.platforms[i]);
+    state.static_props.build();
+    
     // Existing
     state.player = new Entity();
     state.player->set_position(glm::vec3(0.0f, 3.75f, 0.0f));
@@ -233,6 +266,9 @@ void initialise()
     state.player->set_acceleration(glm::vec3(0.0f, -0.3f, 0.0f));
     state.player->texture_id = load_texture(SPRITESHEET_FILEPATH);
     
+    // Loaded once here rather than every time the text is drawn
+    state.font_texture_id = load_texture(FONT_FILEPATH);
+    
     // Jumping
     state.player->jumping_power = 3.0f;
     
@@ -297,7 +333,7 @@ void process_input()
     }
 }
 
-void update()
+bool update()
 {
     float ticks = (float)SDL_GetTicks() / MILLISECONDS_IN_SECOND;
     float delta_time = ticks - previous_ticks;
@@ -308,7 +344,7 @@ void update()
     if (delta_time < FIXED_TIMESTEP)
     {
         accumulator = delta_time;
-        return;
+        return false;
     }
     
     while (delta_time >= FIXED_TIMESTEP) {
@@ -318,6 +354,8 @@ void update()
     }
     
     accumulator = delta_time;
+    
+    return true;
 }
 
 void render()
@@ -326,9 +364,9 @@ void render()
     
     state.player->render(&program);
     
-    for (int i = 0; i < PLATFORM_COUNT; i++) state.platforms[i].render(&program);
+    state.static_props.render(&program);
 
-    GLuint font_texture_id = load_texture(FONT_FILEPATH);
+    GLuint font_texture_id = state.font_texture_id;
     if (state.player->landed) {
         DrawText(&program, font_texture_id, "mission success", 1.0f, -0.5f, glm::vec3(-3.0f, 0.0f, 0.0f));
     }
@@ -342,6 +380,9 @@ void render()
 
 void shutdown()
 {    
+    state.static_props.release();
+    for (size_t i = 0; i < state.text_cache.size(); i++) glDeleteBuffers(1, &state.text_cache[i].buffer);
+    glDeleteTextures(1, &state.font_texture_id);
     SDL_Quit();
     
     delete [] state.platforms;
@@ -355,11 +396,19 @@ int main(int argc, char* argv[])
 {
     initialise();
     
+    FramePacer pacer(FRAME_PACING_MODE, FRAME_RATE_CAP);
+    
     while (game_is_running)
     {
+        pacer.begin_frame();
+        
         process_input();
-        update();
-        render();
+        bool advanced = update();
+        
+        bool rendered = pacer.should_render(advanced);
+        if (rendered) render();
+        
+        pacer.end_frame(rendered);
     }
     
     shutdown();
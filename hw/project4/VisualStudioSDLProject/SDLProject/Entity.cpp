@@ -195,26 +195,6 @@ void Entity::update(float delta_time, Entity *player, Entity *objects, int objec
     
     if (entity_type == ENEMY) activate_ai(player);
     
-    if (animation_indices != NULL)
-    {
-        if (true) // glm::length(movement) != 0 //don't know why!!!!!!!!!!!!
-        {
-            animation_time += delta_time;
-            float frames_per_second = (float) 1 / SECONDS_PER_FRAME;
-            
-            if (animation_time >= frames_per_second)
-            {
-                animation_time = 0.0f;
-                animation_index++;
-                
-                if (animation_index >= animation_frames)
-                {
-                    animation_index = 0;
-                }
-            }
-        }
-    }
-    
 
     // Our character moves from left to right, so they need an initial velocity
     velocity.x = movement.x * speed;
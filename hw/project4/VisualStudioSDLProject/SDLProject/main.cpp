@@ -3,6 +3,8 @@
 #define LOG(argument) std::cout << argument << '\n'
 #define GL_GLEXT_PROTOTYPES 1
 #define FIXED_TIMESTEP 0.0166666f
+#define FRAME_PACING_MODE VSYNC_PACING
+#define FRAME_RATE_CAP 60.0f // capped and on-demand pacing only
 #define ENEMY_COUNT 3
 #define LEVEL1_WIDTH 20
 #define LEVEL1_HEIGHT 5
@@ -17,12 +19,14 @@
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 #include "ShaderProgram.h"
+#include "FramePacer.h"
 #include "stb_image.h"
 #include "cmath"
 #include <ctime>
 #include <vector>
 #include "Entity.h"
 #include "Map.h"
+#include "AnimationSystem.h"
 
 #include <stdlib.h> // for srand
 #include <time.h> // for time
@@ -37,6 +41,7 @@ struct GameState
     Entity *enemies;
     
     Map *map;
+    AnimationSystem animations;
     
     Mix_Music *bgm;
     Mix_Chunk *jump_sfx;
@@ -336,6 +341,10 @@ void initialise()
     state.enemies[2].set_height(0.8f);
     state.enemies[2].set_width(0.8f);
     
+    // Animation
+    state.animations.add(state.player);
+    for (int i = 0; i < ENEMY_COUNT; i++) state.animations.add(&state.enemies[i]);
+    
     
     /**
      BGM and SFX
@@ -435,7 +444,7 @@ void process_input()
     }
 }
 
-void update()
+bool update()
 {
     float ticks = (float)SDL_GetTicks() / MILLISECONDS_IN_SECOND;
     float delta_time = ticks - previous_ticks;
@@ -446,7 +455,7 @@ void update()
     if (delta_time < FIXED_TIMESTEP)
     {
         accumulator = delta_time;
-        return;
+        return false;
     }
     
     while (delta_time >= FIXED_TIMESTEP) {
@@ -454,6 +463,7 @@ void update()
         state.player->update(FIXED_TIMESTEP, state.player, state.enemies, ENEMY_COUNT, state.map);
         
         for (int i = 0; i < ENEMY_COUNT; i++) state.enemies[i].update(FIXED_TIMESTEP, state.player, NULL, 0, state.map);
+        state.animations.advance(FIXED_TIMESTEP);
         
         delta_time -= FIXED_TIMESTEP;
     }
@@ -462,6 +472,8 @@ void update()
     
     view_matrix = glm::mat4(1.0f);
     view_matrix = glm::translate(view_matrix, glm::vec3(-state.player->get_position().x, 0.0f, 0.0f));
+    
+    return true;
 }
 
 void render()
@@ -521,15 +533,24 @@ void shutdown()
 int main(int argc, char* argv[])
 {
     initialise();
+    
+    FramePacer pacer(FRAME_PACING_MODE, FRAME_RATE_CAP);
+    
     while (game_is_running)
     {
         if (game_reset) {
             game_reset = false;
             // initialise(); // bad
         }
+        pacer.begin_frame();
+        
         process_input();
-        update();
-        render();
+        bool advanced = update();
+        
+        bool rendered = pacer.should_render(advanced);
+        if (rendered) render();
+        
+        pacer.end_frame(rendered);
     }
 
     return 0;
@@ -0,0 +1,73 @@
+#include "AnimationSystem.h"
+#include "Entity.h"
+
+void AnimationSystem::add(Entity *entity)
+{
+    // Entities are registered even before they have an animation; gather() skips them until they do
+    this->owners.push_back(entity);
+    this->states.push_back(AnimationState());
+}
+
+void AnimationSystem::clear()
+{
+    this->owners.clear();
+    this->states.clear();
+}
+
+void AnimationSystem::advance(float delta_time)
+{
+    this->gather();
+    this->sweep(delta_time);
+    this->scatter();
+}
+
+void AnimationSystem::gather()
+{
+    // Input and AI still swap animation_indices and reset animation_index on the entity itself,
+    // so pick those up before the sweep
+    for (int i = 0; i < this->get_count(); i++)
+    {
+        Entity *entity = this->owners[i];
+        AnimationState &state = this->states[i];
+
+        state.frames  = entity->animation_frames;
+        state.index   = entity->animation_index;
+        state.time    = entity->animation_time;
+        state.playing = entity->get_active_state() && entity->animation_indices != NULL;
+    }
+}
+
+void AnimationSystem::sweep(float delta_time)
+{
+    float seconds_per_frame = (float) 1 / Entity::SECONDS_PER_FRAME;
+
+    for (int i = 0; i < this->get_count(); i++)
+    {
+        AnimationState &state = this->states[i];
+        if (!state.playing) continue;
+
+        // Animations play whether or not the entity is moving, as they always have here
+        state.time += delta_time;
+
+        if (state.time >= seconds_per_frame)
+        {
+            state.time = 0.0f;
+            state.index++;
+
+            if (state.index >= state.frames) state.index = 0;
+        }
+    }
+}
+
+void AnimationSystem::scatter()
+{
+    for (int i = 0; i < this->get_count(); i++)
+    {
+        Entity *entity = this->owners[i];
+        AnimationState &state = this->states[i];
+        if (!state.playing) continue;
+
+        entity->animation_index = state.index;
+        entity->animation_time  = state.time;
+    }
+}
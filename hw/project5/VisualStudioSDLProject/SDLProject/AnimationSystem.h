@@ -0,0 +1,33 @@
+#pragma once
+#include <vector>
+
+class Entity;
+
+/**
+ Flat copy of everything the animation sweep needs from an entity, so the
+ per-step loop walks one contiguous array instead of the whole Entity object.
+ */
+struct AnimationState
+{
+    int   frames  = 0;
+    int   index   = 0;
+    float time    = 0.0f;
+    bool  playing = false;
+};
+
+class AnimationSystem {
+private:
+    std::vector<Entity*>        owners;
+    std::vector<AnimationState> states;
+
+    void gather();
+    void sweep(float delta_time);
+    void scatter();
+
+public:
+    void add(Entity *entity);
+    void clear();
+    void advance(float delta_time);
+
+    int const get_count() const { return (int) this->states.size(); }
+};
@@ -0,0 +1,165 @@
+#include "BackgroundCache.h"
+#include <algorithm>
+
+BackgroundCache::~BackgroundCache()
+{
+    this->destroy();
+}
+
+bool BackgroundCache::create(float half_view_width, float half_view_height, float pixels_per_unit, float margin,
+                             glm::mat4 projection_matrix)
+{
+    this->destroy();
+    
+    this->half_view_width = half_view_width;
+    this->half_view_height = half_view_height;
+    this->pixels_per_unit = pixels_per_unit;
+    this->projection_matrix = projection_matrix;
+    
+    this->width  = (int) ceil((half_view_width + margin) * 2 * pixels_per_unit);
+    this->height = (int) ceil(half_view_height * 2 * pixels_per_unit);
+    
+    glGenTextures(1, &this->texture_id);
+    glBindTexture(GL_TEXTURE_2D, this->texture_id);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, this->width, this->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    
+    // Repeating across is what makes it a ring; up and down it never goes past the edge
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    
+    glGenFramebuffers(1, &this->framebuffer_id);
+    glBindFramebuffer(GL_FRAMEBUFFER, this->framebuffer_id);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->texture_id, 0);
+    
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        this->destroy();
+        return false;
+    }
+    
+    this->created = true;
+    return true;
+}
+
+void BackgroundCache::destroy()
+{
+    if (this->framebuffer_id != 0) glDeleteFramebuffers(1, &this->framebuffer_id);
+    if (this->texture_id != 0)     glDeleteTextures(1, &this->texture_id);
+    
+    this->framebuffer_id = 0;
+    this->texture_id = 0;
+    this->map = NULL;
+    this->created = false;
+}
+
+void BackgroundCache::update(Map *map, ShaderProgram *program, glm::mat4 view_matrix)
+{
+    // The view matrix only ever translates, by minus the camera's position
+    this->camera_x = -view_matrix[3][0];
+    float camera_y = -view_matrix[3][1];
+    
+    int visible_first = (int) floor((this->camera_x - this->half_view_width) * this->pixels_per_unit);
+    int visible_last  = (int) ceil((this->camera_x + this->half_view_width) * this->pixels_per_unit);
+    
+    bool redraw_all = map != this->map || camera_y != this->camera_y;
+    if (!redraw_all && visible_first >= this->first_column && visible_last <= this->first_column + this->width) return;
+    
+    // Recentre, so there's margin again on both sides
+    int first_column = (visible_first + visible_last) / 2 - this->width / 2;
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, this->framebuffer_id);
+    
+    // Tiles never overlap, so each texel is written once; blending would only square the alpha
+    GLboolean blending = glIsEnabled(GL_BLEND);
+    glDisable(GL_BLEND);
+    glEnable(GL_SCISSOR_TEST);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    
+    this->camera_y = camera_y;
+    program->SetViewMatrix(glm::mat4(1.0f));
+    
+    if (redraw_all || first_column >= this->first_column + this->width || first_column + this->width <= this->first_column)
+    {
+        this->draw_columns(map, program, first_column, first_column + this->width);
+    }
+    else if (first_column > this->first_column)
+    {
+        this->draw_columns(map, program, this->first_column + this->width, first_column + this->width);
+    }
+    else
+    {
+        this->draw_columns(map, program, first_column, this->first_column);
+    }
+    
+    this->map = map;
+    this->first_column = first_column;
+    
+    glDisable(GL_SCISSOR_TEST);
+    if (blending) glEnable(GL_BLEND);
+    program->SetProjectionMatrix(this->projection_matrix);
+    program->SetViewMatrix(view_matrix);
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+void BackgroundCache::draw_columns(Map *map, ShaderProgram *program, int first, int last)
+{
+    float top    = this->camera_y + this->half_view_height;
+    float bottom = top - (float) this->height / this->pixels_per_unit;
+    
+    // The columns wrap around the texture's right edge at most once, so at most two pieces
+    while (first < last)
+    {
+        int texel = ((first % this->width) + this->width) % this->width;
+        int count = std::min(last - first, this->width - texel);
+        
+        glViewport(texel, 0, count, this->height);
+        glScissor(texel, 0, count, this->height);
+        glClear(GL_COLOR_BUFFER_BIT);
+        
+        program->SetProjectionMatrix(glm::ortho(first / this->pixels_per_unit, (first + count) / this->pixels_per_unit,
+                                                bottom, top, -1.0f, 1.0f));
+        map->render(program);
+        
+        first += count;
+    }
+}
+
+bool BackgroundCache::render(const Map *map, ShaderProgram *program)
+{
+    if (map == NULL || map != this->map) return false;
+    
+    float left   = this->camera_x - this->half_view_width;
+    float right  = this->camera_x + this->half_view_width;
+    float top    = this->camera_y + this->half_view_height;
+    float bottom = this->camera_y - this->half_view_height;
+    
+    // u counts whole trips around the ring, which GL_REPEAT throws away
+    float u_left   = left * this->pixels_per_unit / this->width;
+    float u_right  = right * this->pixels_per_unit / this->width;
+    float v_bottom = 1.0f - (top - bottom) * this->pixels_per_unit / this->height;
+    
+    float vertices[] = { left, top, left, bottom, right, bottom, left, top, right, bottom, right, top };
+    float texture_coordinates[] = { u_left, 1.0f, u_left, v_bottom, u_right, v_bottom,
+                                    u_left, 1.0f, u_right, v_bottom, u_right, 1.0f };
+    
+    program->SetModelMatrix(glm::mat4(1.0f));
+    
+    glVertexAttribPointer(program->positionAttribute, 2, GL_FLOAT, false, 0, vertices);
+    glEnableVertexAttribArray(program->positionAttribute);
+    glVertexAttribPointer(program->texCoordAttribute, 2, GL_FLOAT, false, 0, texture_coordinates);
+    glEnableVertexAttribArray(program->texCoordAttribute);
+    
+    glBindTexture(GL_TEXTURE_2D, this->texture_id);
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    
+    glDisableVertexAttribArray(program->positionAttribute);
+    glDisableVertexAttribArray(program->texCoordAttribute);
+    
+    return true;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "ShaderProgram.h"
+#include "Map.h"
+
+/**
+ The map drawn once into a texture wider than the view, so each frame it's one textured quad instead of
+ every tile. The texture is a ring: texel column c holds world column c modulo its width, and it
+ samples with GL_REPEAT, so however far the camera has gone the quad never needs splitting. When the
+ camera pans past what's cached, the cache recentres on it and draws only the columns that weren't
+ there before. The camera moving up or down, or a different map, redraws the lot.
+ */
+class BackgroundCache {
+private:
+    GLuint framebuffer_id = 0;
+    GLuint texture_id = 0;
+    int width = 0;  // texels
+    int height = 0;
+    
+    float half_view_width = 0.0f;  // world units either side of the camera
+    float half_view_height = 0.0f;
+    float pixels_per_unit = 0.0f;
+    glm::mat4 projection_matrix;   // the scene's, put back after drawing into the cache
+    
+    const Map *map = NULL;   // what's cached; NULL when nothing is
+    int first_column = 0;    // world texel columns first_column to first_column + width are cached
+    float camera_x = 0.0f;   // as of the last update
+    float camera_y = 0.0f;
+    
+    bool created = false;
+    
+    void draw_columns(Map *map, ShaderProgram *program, int first, int last);
+    
+public:
+    BackgroundCache() {}
+    BackgroundCache(const BackgroundCache &) = delete;
+    BackgroundCache &operator=(const BackgroundCache &) = delete;
+    ~BackgroundCache();
+    
+    // The view is what projection_matrix shows; margin is how many world units are kept either side of
+    // it, so a camera moving slower than that per frame redraws a strip only every so often. False if
+    // the driver won't give a complete framebuffer
+    bool create(float half_view_width, float half_view_height, float pixels_per_unit, float margin,
+                glm::mat4 projection_matrix);
+    void destroy();
+    
+    // Draws whatever the camera has newly brought into range. Call outside the scene's drawing: it
+    // binds its own framebuffer and viewport and leaves the window's framebuffer bound
+    void update(Map *map, ShaderProgram *program, glm::mat4 view_matrix);
+    
+    // The map's next update redraws everything
+    void invalidate() { this->map = NULL; }
+    
+    // The cached map as one quad over the last update's view, drawn with the scene's matrices. False
+    // (and nothing drawn) if map isn't the one cached
+    bool render(const Map *map, ShaderProgram *program);
+    
+    bool const is_created() const { return this->created; }
+    GLuint const get_texture_id() const { return this->texture_id; }
+};
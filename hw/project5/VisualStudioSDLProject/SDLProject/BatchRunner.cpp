@@ -0,0 +1,173 @@
+#include "BatchRunner.h"
+#include <random>
+#include "LevelA.h"
+#include "LevelB.h"
+#include "LevelC.h"
+
+static Scene *create_level(int level)
+{
+    switch (level)
+    {
+        case 2: return new LevelB();
+        case 3: return new LevelC();
+        default: return new LevelA();
+    }
+}
+
+static Scene *load_level(const SimulationConfig &config)
+{
+    Scene *scene = create_level(config.level);
+    scene->headless = true;
+    scene->initialise();
+    
+    Entity *player = scene->state.player;
+    player->speed         = config.speed;
+    player->jumping_power = config.jumping_power;
+    player->dashing_speed = config.dashing_speed;
+    player->set_acceleration(glm::vec3(0.0f, config.gravity, 0.0f));
+    
+    // threat_count starts out as the level's enemy count
+    for (int i = 0; i < player->get_threat_count(); i++)
+    {
+        scene->state.enemies[i].set_acceleration(glm::vec3(0.0f, config.gravity, 0.0f));
+    }
+    
+    return scene;
+}
+
+// Same effect on the player as a frame of process_input
+static void apply_input(Entity *player, const InputFrame &input)
+{
+    player->set_movement(glm::vec3(input.move_x, 0.0f, 0.0f));
+    
+    if (input.jump && player->collided_bottom) player->is_jumping = true;
+    if (input.dash)   player->is_dashing   = true;
+    if (input.shield) player->is_shielding = true;
+}
+
+// Holds each choice for a while, the way someone pressing keys would
+static InputFrame random_input(std::mt19937 &random, InputFrame &held, int &hold_steps)
+{
+    if (hold_steps-- > 0) return held;
+    
+    std::uniform_int_distribution<int> direction(-1, 1);
+    std::uniform_int_distribution<int> hold(10, 60);
+    std::uniform_int_distribution<int> percent(0, 99);
+    
+    held.move_x = (float) direction(random);
+    held.jump   = percent(random) < 30;
+    held.dash   = percent(random) < 5;
+    held.shield = percent(random) < 10;
+    hold_steps  = hold(random);
+    
+    return held;
+}
+
+SimulationResult BatchRunner::simulate(const SimulationConfig &config)
+{
+    SimulationResult result;
+    std::mt19937 random(config.seed);
+    
+    InputFrame held;
+    int hold_steps = 0;
+    
+    Scene *scene = load_level(config);
+    result.threat_counts.push_back(scene->state.player->get_threat_count());
+    
+    for (int step = 0; step < config.max_steps; step++)
+    {
+        InputFrame input = (config.script != NULL && !config.script->empty())
+            ? (*config.script)[step % config.script->size()]
+            : random_input(random, held, hold_steps);
+        
+        apply_input(scene->state.player, input);
+        scene->update(BATCH_TIMESTEP);
+        result.steps = step + 1;
+        
+        Entity *player = scene->state.player;
+        if ((step + 1) % BATCH_SAMPLES_PER_SECOND == 0) result.threat_counts.push_back(player->get_threat_count());
+        
+        // Same rules as main.cpp's render: losing a life restarts the level, clearing its threats wins it
+        if (!player->get_active_state())
+        {
+            result.deaths++;
+            if (result.deaths >= config.lives) break;
+            
+            delete scene;
+            scene = load_level(config);
+        }
+        else if (player->get_threat_count() == 0)
+        {
+            result.completed = true;
+            break;
+        }
+    }
+    
+    result.threat_counts.push_back(scene->state.player->get_threat_count());
+    delete scene;
+    
+    return result;
+}
+
+std::vector<SimulationResult> BatchRunner::run(const std::vector<SimulationConfig> &configs)
+{
+    std::vector<SimulationResult> results(configs.size());
+    
+    // Every job writes only its own slot, so no locking is needed around the results
+    for (size_t i = 0; i < configs.size(); i++)
+    {
+        const SimulationConfig *config = &configs[i];
+        SimulationResult *result = &results[i];
+        
+        this->pool.submit([config, result] { *result = BatchRunner::simulate(*config); });
+    }
+    this->pool.wait();
+    
+    return results;
+}
+
+BatchReport BatchRunner::summarise(const std::vector<SimulationResult> &results)
+{
+    BatchReport report;
+    report.runs = (int) results.size();
+    if (results.empty()) return report;
+    
+    size_t samples = 0;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        if (results[i].threat_counts.size() > samples) samples = results[i].threat_counts.size();
+    }
+    report.mean_threat_counts.assign(samples, 0.0f);
+    
+    float total_time   = 0.0f;
+    int   total_deaths = 0;
+    
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const SimulationResult &result = results[i];
+        total_deaths += result.deaths;
+        
+        if (result.completed)
+        {
+            float time = result.steps * BATCH_TIMESTEP;
+            if (report.completed == 0 || time < report.best_completion_time) report.best_completion_time = time;
+            
+            total_time += time;
+            report.completed++;
+        }
+        
+        // A run that ended early keeps its last value for the rest of the timeline
+        for (size_t j = 0; j < samples; j++)
+        {
+            const std::vector<int> &counts = result.threat_counts;
+            report.mean_threat_counts[j] += counts[j < counts.size() ? j : counts.size() - 1];
+        }
+    }
+    
+    for (size_t j = 0; j < samples; j++) report.mean_threat_counts[j] /= results.size();
+    
+    report.mean_deaths = (float) total_deaths / results.size();
+    if (report.completed > 0) report.mean_completion_time = total_time / report.completed;
+    
+    return report;
+}
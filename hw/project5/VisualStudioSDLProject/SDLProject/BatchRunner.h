@@ -0,0 +1,78 @@
+#pragma once
+#include <vector>
+#include "WorkStealingPool.h"
+
+#define BATCH_TIMESTEP 0.0166666f
+#define BATCH_SAMPLES_PER_SECOND 60 // threat_count is recorded once per simulated second
+
+/**
+ One frame of player input, the same things process_input sets on the player.
+ */
+struct InputFrame
+{
+    float move_x = 0.0f;
+    bool jump    = false;
+    bool dash    = false;
+    bool shield  = false;
+};
+
+/**
+ Everything one simulation needs. Tuning values are applied to the player after the level loads, so
+ the level files themselves stay as they are.
+ */
+struct SimulationConfig
+{
+    int level = 1; // 1-3 for LevelA-C
+    unsigned int seed = 0;
+    
+    float speed         = 2.5f;
+    float jumping_power = 5.0f;
+    float dashing_speed = 100.0f;
+    float gravity       = -9.81f;
+    
+    int lives     = 3;
+    int max_steps = 60 * 60;
+    
+    // Played back one frame per step, looping; when empty, input is random from seed
+    const std::vector<InputFrame> *script = NULL;
+};
+
+struct SimulationResult
+{
+    bool completed = false;
+    int steps  = 0;
+    int deaths = 0;
+    std::vector<int> threat_counts;
+};
+
+struct BatchReport
+{
+    int runs      = 0;
+    int completed = 0;
+    
+    float mean_completion_time = 0.0f;
+    float best_completion_time = 0.0f;
+    float mean_deaths          = 0.0f;
+    
+    // Average threat_count at each simulated second, across every run
+    std::vector<float> mean_threat_counts;
+};
+
+/**
+ Runs independent headless simulations of a level across a work-stealing pool. Each simulation owns its
+ own Scene, random generator and result slot and nothing else is shared, so it scales with cores.
+ */
+class BatchRunner {
+private:
+    WorkStealingPool pool;
+    
+public:
+    explicit BatchRunner(int thread_count = 0) : pool(thread_count) {}
+    
+    static SimulationResult simulate(const SimulationConfig &config);
+    
+    std::vector<SimulationResult> run(const std::vector<SimulationConfig> &configs);
+    static BatchReport summarise(const std::vector<SimulationResult> &results);
+    
+    int const get_thread_count() const { return this->pool.get_thread_count(); }
+};
@@ -15,9 +15,9 @@
 
 Entity::Entity()
 {
-    position     = glm::vec3(0.0f);
-    velocity     = glm::vec3(0.0f);
-    acceleration = glm::vec3(0.0f);
+    position     = physics_vec3(glm::vec3(0.0f));
+    velocity     = physics_vec3(glm::vec3(0.0f));
+    acceleration = physics_vec3(glm::vec3(0.0f));
     
     movement = glm::vec3(0.0f);
     
@@ -111,7 +111,7 @@ void Entity::ai_guard(Entity *player)
 {
     switch (ai_state) {
         case IDLE:
-            if (glm::distance(position, player->position) < 2.0f) ai_state = WALKING;
+            if (glm::distance(get_position(), player->get_position()) < 2.0f) ai_state = WALKING;
             break;
             
         case WALKING:
@@ -135,11 +135,11 @@ void Entity::ai_ekimmara(Entity* player)
     switch (ai_state) {
     case IDLE:
         animation_indices = walking[UP];  // start UP = idle
-        if (glm::distance(position, player->position) < 4.0f) ai_state = BUFFER;
+        if (glm::distance(get_position(), player->get_position()) < 4.0f) ai_state = BUFFER;
         break;
     case BUFFER:
         animation_indices = walking[DOWN];  // DOWN = cloaking
-        if (glm::distance(position, player->position) < 2.0f) ai_state = WALKING;
+        if (glm::distance(get_position(), player->get_position()) < 2.0f) ai_state = WALKING;
         break;
     case WALKING:
         if (player->is_jumping) {
@@ -164,7 +164,7 @@ void Entity::ai_wyvern(Entity* player)
     switch (ai_state) {
     case IDLE:
         animation_indices = walking[UP];  // start UP = idle
-        if (glm::distance(position, player->position) < 4.0f) ai_state = ENGAGING;
+        if (glm::distance(get_position(), player->get_position()) < 4.0f) ai_state = ENGAGING;
         break;
     case ENGAGING:
         if (position.x > player->get_position().x) {
@@ -175,13 +175,21 @@ void Entity::ai_wyvern(Entity* player)
             animation_indices = walking[RIGHT];
             movement.x = 1.0f;
         }
-        velocity.y += pow((position.x - 7.0f), 2) - pow(position.y,2);
+        velocity.y += (position.x - 7.0f) * (position.x - 7.0f) - position.y * position.y;
     default:
         break;
     }
 }
 
 
+void Entity::emit(GameEventType type, Entity *target, Entity *credited)
+{
+    GameEvent event = { type, this, target, credited };
+    
+    if (events != NULL) events->emit(event);
+    else EventBus::apply(event, NULL);
+}
+
 void Entity::update(float delta_time, Entity *player, Entity *objects, int object_count, Map *map)
 {
     if (!is_active) return;
@@ -195,26 +203,9 @@ void Entity::update(float delta_time, Entity *player, Entity *objects, int objec
     
     if (entity_type == ENEMY) activate_ai(player);
     
-    if (animation_indices != NULL)
-    {
-        if (true) // glm::length(movement) != 0 //don't know why!!!!!!!!!!!!
-        {
-            animation_time += delta_time;
-            float frames_per_second = (float) 1 / SECONDS_PER_FRAME;
-            
-            if (animation_time >= frames_per_second)
-            {
-                animation_time = 0.0f;
-                animation_index++;
-                
-                if (animation_index >= animation_frames)
-                {
-                    animation_index = 0;
-                }
-            }
-        }
-    }
-    
+
+    // Converted once so every product below stays in the physics scalar
+    physics_scalar step = delta_time;
 
     // Our character moves from left to right, so they need an initial velocity
     velocity.x = movement.x * speed;
@@ -234,7 +225,7 @@ void Entity::update(float delta_time, Entity *player, Entity *objects, int objec
     }
 
     // Now we add the rest of the gravity physics
-    velocity += acceleration * delta_time;
+    velocity += acceleration * step;
 
     // Jump
     if (is_jumping)
@@ -247,23 +238,20 @@ void Entity::update(float delta_time, Entity *player, Entity *objects, int objec
         velocity.y += jumping_power;
     }
     
-    position.y += velocity.y * delta_time;
+    position.y += velocity.y * step;
     check_collision_y(objects, object_count);
     check_collision_y(map);
 
     
-    position.x += velocity.x * delta_time;
+    position.x += velocity.x * step;
     check_collision_x(objects, object_count);
     check_collision_x(map);
     
-    if (entity_type == PLAYER && position.y < -10.0f) deactivate();
-    else if (entity_type == ENEMY && position.y < -10.0f) {
-        deactivate();
-        player->threat_count -= 1;
-    }
+    if (entity_type == PLAYER && position.y < -10.0f) emit(DEATH_EVENT, this, NULL);
+    else if (entity_type == ENEMY && position.y < -10.0f) emit(DEATH_EVENT, this, player);
 
     model_matrix = glm::mat4(1.0f);
-    model_matrix = glm::translate(model_matrix, position);
+    model_matrix = glm::translate(model_matrix, get_position());
     clear_bools();
 }
 
@@ -275,8 +263,8 @@ void const Entity::check_collision_y(Entity *collidable_entities, int collidable
         
         if (check_collision(collidable_entity))
         {
-            float y_distance = fabs(position.y - collidable_entity->position.y);
-            float y_overlap = fabs(y_distance - (height / 2.0f) - (collidable_entity->height / 2.0f));
+            physics_scalar y_distance = fabs(position.y - collidable_entity->position.y);
+            physics_scalar y_overlap = fabs(y_distance - (height / 2.0f) - (collidable_entity->height / 2.0f));
             if (velocity.y > 0) {
                 // position.y   -= y_overlap;
                 // velocity.y    = 0;
@@ -287,11 +275,10 @@ void const Entity::check_collision_y(Entity *collidable_entities, int collidable
                 collided_bottom  = true;
             }
             if (entity_type == PLAYER && invincible == false) {
-                deactivate();
+                emit(DEATH_EVENT, this, NULL);
             }
             else if (entity_type == PLAYER && invincible == true) {
-                collidable_entity->deactivate();
-                threat_count -= 1;
+                emit(DEATH_EVENT, collidable_entity, this);
             }
         }
     }
@@ -305,8 +292,8 @@ void const Entity::check_collision_x(Entity *collidable_entities, int collidable
         
         if (check_collision(collidable_entity))
         {
-            float x_distance = fabs(position.x - collidable_entity->position.x);
-            float x_overlap = fabs(x_distance - (width / 2.0f) - (collidable_entity->width / 2.0f));
+            physics_scalar x_distance = fabs(position.x - collidable_entity->position.x);
+            physics_scalar x_overlap = fabs(x_distance - (width / 2.0f) - (collidable_entity->width / 2.0f));
             if (velocity.x > 0) {
                 // position.x     -= x_overlap;
                 // velocity.x      = 0;
@@ -317,11 +304,10 @@ void const Entity::check_collision_x(Entity *collidable_entities, int collidable
                 collided_left  = true;
             }
             if (entity_type == PLAYER && invincible == false) {
-                deactivate();
+                emit(DEATH_EVENT, this, NULL);
             }
             else if (entity_type == PLAYER && invincible == true) {
-                collidable_entity->deactivate();
-                threat_count -= 1;
+                emit(DEATH_EVENT, collidable_entity, this);
             }
         }
     }
@@ -330,16 +316,16 @@ void const Entity::check_collision_x(Entity *collidable_entities, int collidable
 void const Entity::check_collision_y(Map *map)
 {
     // Probes for tiles
-    glm::vec3 top = glm::vec3(position.x, position.y + (height / 2), position.z);
-    glm::vec3 top_left = glm::vec3(position.x - (width / 2), position.y + (height / 2), position.z);
-    glm::vec3 top_right = glm::vec3(position.x + (width / 2), position.y + (height / 2), position.z);
+    physics_vec3 top = physics_vec3(position.x, position.y + (height / 2), position.z);
+    physics_vec3 top_left = physics_vec3(position.x - (width / 2), position.y + (height / 2), position.z);
+    physics_vec3 top_right = physics_vec3(position.x + (width / 2), position.y + (height / 2), position.z);
     
-    glm::vec3 bottom = glm::vec3(position.x, position.y - (height / 2), position.z);
-    glm::vec3 bottom_left = glm::vec3(position.x - (width / 2), position.y - (height / 2), position.z);
-    glm::vec3 bottom_right = glm::vec3(position.x + (width / 2), position.y - (height / 2), position.z);
+    physics_vec3 bottom = physics_vec3(position.x, position.y - (height / 2), position.z);
+    physics_vec3 bottom_left = physics_vec3(position.x - (width / 2), position.y - (height / 2), position.z);
+    physics_vec3 bottom_right = physics_vec3(position.x + (width / 2), position.y - (height / 2), position.z);
     
-    float penetration_x = 0;
-    float penetration_y = 0;
+    physics_scalar penetration_x = 0;
+    physics_scalar penetration_y = 0;
     
     if (map->is_solid(top, &penetration_x, &penetration_y) && velocity.y > 0)
     {
@@ -384,11 +370,11 @@ void const Entity::check_collision_y(Map *map)
 void const Entity::check_collision_x(Map *map)
 {
     // Probes for tiles
-    glm::vec3 left = glm::vec3(position.x - (width / 2), position.y, position.z);
-    glm::vec3 right = glm::vec3(position.x + (width / 2), position.y, position.z);
+    physics_vec3 left = physics_vec3(position.x - (width / 2), position.y, position.z);
+    physics_vec3 right = physics_vec3(position.x + (width / 2), position.y, position.z);
     
-    float penetration_x = 0;
-    float penetration_y = 0;
+    physics_scalar penetration_x = 0;
+    physics_scalar penetration_y = 0;
     
     if (map->is_solid(left, &penetration_x, &penetration_y) && velocity.x < 0)
     {
@@ -440,8 +426,8 @@ bool const Entity::check_collision(Entity *other) const
     // If either entity is inactive, there shouldn't be any collision
     if (!is_active || !other->is_active) return false;
     
-    float x_distance = fabs(position.x - other->position.x) - ((width  + other->width)  / 2.0f);
-    float y_distance = fabs(position.y - other->position.y) - ((height + other->height) / 2.0f);
+    physics_scalar x_distance = fabs(position.x - other->position.x) - ((width  + other->width)  / 2.0f);
+    physics_scalar y_distance = fabs(position.y - other->position.y) - ((height + other->height) / 2.0f);
     
     return x_distance < 0.0f && y_distance < 0.0f;
 }
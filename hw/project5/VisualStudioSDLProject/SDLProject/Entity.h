@@ -1,5 +1,7 @@
 #pragma once
 #include "Map.h"
+#include "Physics.h"
+#include "EventBus.h"
 
 enum EntityType { PLATFORM, PLAYER, ENEMY  };
 enum AIType     { WALKER, GUARD, EKIMMARA, WYVERN  };
@@ -18,12 +20,13 @@ private:
     int *animation_up    = NULL; // move upwards
     int *animation_down  = NULL; // move downwards
     
-    glm::vec3 position;
-    glm::vec3 velocity;
-    glm::vec3 acceleration;
+    // Physics state lives in physics_scalar (float, or Q16.16 under PHYSICS_FIXED_POINT)
+    physics_vec3 position;
+    physics_vec3 velocity;
+    physics_vec3 acceleration;
     
-    float width  = 0.8f;
-    float height = 0.8f;
+    physics_scalar width  = 0.8f;
+    physics_scalar height = 0.8f;
 
     bool invincible = false;
     int threat_count;
@@ -67,6 +70,10 @@ public:
     // Additional
     bool is_still = true;
     
+    // Deaths caused during a step go here; NULL applies them immediately
+    EventBus *events = NULL;
+    int event_order = 0; // where this entity's events go when the bus resolves; set by EventBus::attach
+    
     // Colliding
     bool collided_top    = false;
     bool collided_bottom = false;
@@ -92,6 +99,7 @@ public:
     void const check_collision_x(Map *map);
     
     bool const check_collision(Entity *other) const;
+    void emit(GameEventType type, Entity *target, Entity *credited);
 
     void clear_bools();
 
@@ -102,22 +110,22 @@ public:
     EntityType const get_entity_type()  const { return entity_type;  };
     AIType     const get_ai_type()      const { return ai_type;      };
     AIState    const get_ai_state()     const { return ai_state;     };
-    glm::vec3  const get_position()     const { return position;     };
-    glm::vec3  const get_movement()     const { return movement;     };
-    glm::vec3  const get_velocity()     const { return velocity;     };
-    glm::vec3  const get_acceleration() const { return acceleration; };
-    int        const get_width()        const { return width;        };
-    int        const get_height()       const { return height; };
+    glm::vec3  const get_position()     const { return to_vec3(position);     };
+    glm::vec3  const get_movement()     const { return movement;              };
+    glm::vec3  const get_velocity()     const { return to_vec3(velocity);     };
+    glm::vec3  const get_acceleration() const { return to_vec3(acceleration); };
+    int        const get_width()        const { return (int) width;           };
+    int        const get_height()       const { return (int) height; };
     bool       const get_active_state() const { return is_active; };
     int        const get_threat_count() const { return threat_count; };
     
     void const set_entity_type(EntityType new_entity_type)  { entity_type  = new_entity_type;      };
     void const set_ai_type(AIType new_ai_type)              { ai_type      = new_ai_type;          };
     void const set_ai_state(AIState new_state)              { ai_state     = new_state;            };
-    void const set_position(glm::vec3 new_position)         { position     = new_position;         };
-    void const set_movement(glm::vec3 new_movement)         { movement     = new_movement;         };
-    void const set_velocity(glm::vec3 new_velocity)         { velocity     = new_velocity;         };
-    void const set_acceleration(glm::vec3 new_acceleration) { acceleration = new_acceleration;     };
+    void const set_position(glm::vec3 new_position)         { position     = physics_vec3(new_position);     };
+    void const set_movement(glm::vec3 new_movement)         { movement     = new_movement;                   };
+    void const set_velocity(glm::vec3 new_velocity)         { velocity     = physics_vec3(new_velocity);     };
+    void const set_acceleration(glm::vec3 new_acceleration) { acceleration = physics_vec3(new_acceleration); };
     void const set_width(float new_width)                   { width        = new_width;            };
     void const set_height(float new_height)                 { height       = new_height;           };
     void const set_threat_count(int new_threats) { threat_count = new_threats; };
@@ -0,0 +1,55 @@
+#include "EventBus.h"
+#include <algorithm>
+#include "Entity.h"
+
+void EventBus::attach(Entity *entity)
+{
+    entity->events = this;
+    entity->event_order = this->attached++;
+}
+
+void EventBus::emit(GameEvent event)
+{
+    this->queue.push_back(event);
+}
+
+void EventBus::resolve()
+{
+    this->resolved.clear();
+
+    std::vector<GameEvent> merged;
+    merged.swap(this->queue);
+
+    // An entity's own events are always in the order it emitted them, so a stable sort on the
+    // emitter's attach order gives the same order whichever order the updates ran in
+    std::stable_sort(merged.begin(), merged.end(), [](const GameEvent &a, const GameEvent &b) {
+        return a.source->event_order < b.source->event_order;
+    });
+
+    for (size_t i = 0; i < merged.size(); i++) EventBus::apply(merged[i], &this->resolved);
+}
+
+void EventBus::clear()
+{
+    this->queue.clear();
+    this->resolved.clear();
+    this->attached = 0;
+}
+
+void EventBus::apply(GameEvent event, std::vector<GameEvent> *log)
+{
+    switch (event.type)
+    {
+        case DEATH_EVENT:
+            // The same enemy can be hit on both axes in one step; it only dies (and counts) once
+            if (!event.target->get_active_state()) break;
+
+            event.target->deactivate();
+            if (event.credited != NULL) event.credited->set_threat_count(event.credited->get_threat_count() - 1);
+            if (log != NULL) log->push_back(event);
+            break;
+
+        default:
+            break;
+    }
+}
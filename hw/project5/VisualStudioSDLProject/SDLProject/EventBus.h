@@ -0,0 +1,47 @@
+#pragma once
+#include <stddef.h>
+#include <vector>
+
+class Entity;
+
+enum GameEventType { DEATH_EVENT };
+
+/**
+ Something that happened to an entity during a step. source emitted it; credited is whoever's
+ threat_count goes down when an enemy dies (NULL for nobody).
+ */
+struct GameEvent
+{
+    GameEventType type;
+    Entity *source;
+    Entity *target;
+    Entity *credited;
+};
+
+/**
+ Entities don't change each other while a step is running; they emit events here instead, so entity
+ updates no longer depend on each other's order. Once the step is over resolve() puts the events in
+ one fixed order and applies them. A scene's updates all run on the game thread, so one queue does.
+ */
+class EventBus {
+private:
+    std::vector<GameEvent> queue;
+    std::vector<GameEvent> resolved;
+
+    int attached = 0; // entities attached since the last clear()
+
+public:
+    // The entity emits here from now on. Attach in the order a serial step updates them: resolve()
+    // applies events in that order
+    void attach(Entity *entity);
+
+    void emit(GameEvent event);
+    void resolve();
+    void clear();
+
+    // What the last resolve() applied, in order, for anything that wants to react (sounds, UI)
+    std::vector<GameEvent> const &get_resolved() const { return this->resolved; }
+
+    // Applies a single event straight away, for entities that aren't attached to a bus
+    static void apply(GameEvent event, std::vector<GameEvent> *log);
+};
@@ -0,0 +1,57 @@
+#pragma once
+#include <stdint.h>
+#include <math.h>
+
+/**
+ A signed fixed-point number with FRACTION_BITS bits after the point, stored in 32 bits. Every operation
+ is plain integer arithmetic, so the same inputs give the same bits on any compiler, optimisation level
+ or core; float only comes in when converting to or from the outside world.
+ */
+template <int FRACTION_BITS>
+class Fixed {
+private:
+    int32_t raw;
+
+public:
+    static const int32_t ONE = 1 << FRACTION_BITS;
+
+    Fixed() : raw(0) {}
+    Fixed(int value) : raw(value * ONE) {}
+    Fixed(float value) : raw((int32_t) floor((double) value * ONE + 0.5)) {}
+    Fixed(double value) : raw((int32_t) floor(value * ONE + 0.5)) {}
+
+    static Fixed from_raw(int32_t raw) { Fixed result; result.raw = raw; return result; }
+
+    int32_t const get_raw()  const { return this->raw; }
+    float   const to_float() const { return (float) this->raw / ONE; }
+
+    explicit operator int()   const { return this->raw / ONE; }
+    explicit operator float() const { return this->to_float(); }
+
+    Fixed operator-() const { return from_raw(-this->raw); }
+
+    Fixed &operator+=(Fixed other) { this->raw += other.raw; return *this; }
+    Fixed &operator-=(Fixed other) { this->raw -= other.raw; return *this; }
+    Fixed &operator*=(Fixed other) { *this = *this * other; return *this; }
+    Fixed &operator/=(Fixed other) { *this = *this / other; return *this; }
+
+    // Products and quotients go through 64 bits so the intermediate can't overflow
+    friend Fixed operator+(Fixed a, Fixed b) { return from_raw(a.raw + b.raw); }
+    friend Fixed operator-(Fixed a, Fixed b) { return from_raw(a.raw - b.raw); }
+    friend Fixed operator*(Fixed a, Fixed b) { return from_raw((int32_t) (((int64_t) a.raw * b.raw) >> FRACTION_BITS)); }
+    friend Fixed operator/(Fixed a, Fixed b) { return from_raw((int32_t) (((int64_t) a.raw * ONE) / b.raw)); }
+
+    friend bool operator==(Fixed a, Fixed b) { return a.raw == b.raw; }
+    friend bool operator!=(Fixed a, Fixed b) { return a.raw != b.raw; }
+    friend bool operator< (Fixed a, Fixed b) { return a.raw <  b.raw; }
+    friend bool operator> (Fixed a, Fixed b) { return a.raw >  b.raw; }
+    friend bool operator<=(Fixed a, Fixed b) { return a.raw <= b.raw; }
+    friend bool operator>=(Fixed a, Fixed b) { return a.raw >= b.raw; }
+
+    // Found by argument-dependent lookup, so code written against float's fabs/floor/ceil works unchanged
+    friend Fixed fabs(Fixed a)  { return from_raw(a.raw < 0 ? -a.raw : a.raw); }
+    friend Fixed floor(Fixed a) { return from_raw(a.raw & ~(ONE - 1)); }
+    friend Fixed ceil(Fixed a)  { return from_raw((a.raw + ONE - 1) & ~(ONE - 1)); }
+};
+
+typedef Fixed<16> Fixed16;
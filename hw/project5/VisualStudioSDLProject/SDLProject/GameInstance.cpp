@@ -0,0 +1,314 @@
+#include "GameInstance.h"
+#include <SDL_mixer.h>
+
+#define FIXED_TIMESTEP 0.0166666f
+#define LEVEL1_LEFT_EDGE 5.0f
+#define FRAME_PACING_MODE VSYNC_PACING
+#define FRAME_RATE_CAP 60.0f // capped and on-demand pacing only
+#define IDLE_WAIT_MS 250     // longest an idle scene sleeps without input
+#define RENDER_TARGET_WIDTH 640  // the art's own scale: 64-pixel tiles, ten across the view
+#define RENDER_TARGET_HEIGHT 480
+#define VIEW_HALF_WIDTH 5.0f     // world units either side of the camera
+#define VIEW_HALF_HEIGHT 3.75f
+#define BACKGROUND_MARGIN 5.0f   // world units cached past each side of the view
+
+/**
+ CONSTANTS
+ */
+const int WINDOW_WIDTH  = 640,
+          WINDOW_HEIGHT = 480;
+
+const float BG_RED     = 0.1922f,
+            BG_BLUE    = 0.549f,
+            BG_GREEN   = 0.9059f,
+            BG_OPACITY = 1.0f;
+
+const int VIEWPORT_X = 0,
+          VIEWPORT_Y = 0,
+          VIEWPORT_WIDTH  = WINDOW_WIDTH,
+          VIEWPORT_HEIGHT = WINDOW_HEIGHT;
+
+const char V_SHADER_PATH[] = "shaders/vertex_textured.glsl",
+           F_SHADER_PATH[] = "shaders/fragment_textured.glsl";
+
+const float MILLISECONDS_IN_SECOND = 1000.0;
+
+void GameInstance::switch_to_scene(Scene *scene)
+{
+    this->current_scene = scene;
+    this->current_scene->initialise();
+    this->current_scene->dirty = true;
+    
+    // initialise() made a new map, which may well sit where the old one was
+    this->background_cache.invalidate();
+    if (this->background_cache.is_created()) this->current_scene->background_cache = &this->background_cache;
+}
+
+void GameInstance::initialise()
+{
+    this->display_window = SDL_CreateWindow("Hello, Scenes!",
+                                            SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                                            WINDOW_WIDTH, WINDOW_HEIGHT,
+                                            SDL_WINDOW_OPENGL | SDL_WINDOW_RESIZABLE);
+    
+    this->context = SDL_GL_CreateContext(this->display_window);
+    SDL_GL_MakeCurrent(this->display_window, this->context);
+    
+#ifdef _WINDOWS
+    glewInit();
+#endif
+    
+    glViewport(VIEWPORT_X, VIEWPORT_Y, VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
+    
+    this->program.Load(V_SHADER_PATH, F_SHADER_PATH);
+    
+    this->view_matrix = glm::mat4(1.0f);
+    this->projection_matrix = glm::ortho(-VIEW_HALF_WIDTH, VIEW_HALF_WIDTH, -VIEW_HALF_HEIGHT, VIEW_HALF_HEIGHT, -1.0f, 1.0f);
+    
+    this->program.SetProjectionMatrix(this->projection_matrix);
+    this->program.SetViewMatrix(this->view_matrix);
+    
+    if (!this->render_target.create(RENDER_TARGET_WIDTH, RENDER_TARGET_HEIGHT, V_SHADER_PATH, F_SHADER_PATH))
+    {
+        std::cout << "No offscreen framebuffer; drawing straight to the window\n";
+    }
+    
+    // Same pixels per unit as the render target, so cached texels land one to one on its pixels
+    if (!this->background_cache.create(VIEW_HALF_WIDTH, VIEW_HALF_HEIGHT, RENDER_TARGET_WIDTH / (2 * VIEW_HALF_WIDTH),
+                                       BACKGROUND_MARGIN, this->projection_matrix))
+    {
+        std::cout << "No background cache; maps are drawn tile by tile\n";
+    }
+    
+    glUseProgram(this->program.programID);
+    
+    glClearColor(BG_RED, BG_BLUE, BG_GREEN, BG_OPACITY);
+    
+    this->level_menu = new Level_M();
+    this->level_a = new LevelA();
+    this->level_b = new LevelB();
+    this->level_c = new LevelC();
+    this->level_win = new Level_W();
+    this->level_fail = new Level_F();
+    switch_to_scene(this->level_menu);
+    
+    // enable blending
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    
+    this->pacer = new FramePacer(FRAME_PACING_MODE, FRAME_RATE_CAP);
+}
+
+void GameInstance::process_input()
+{
+    Entity *player = this->current_scene->state.player;
+    
+    // VERY IMPORTANT: If nothing is pressed, we don't want to go anywhere
+    player->set_movement(glm::vec3(0.0f));
+    
+    SDL_Event event;
+    while (SDL_PollEvent(&event))
+    {
+        if (event.type == SDL_KEYDOWN || event.type == SDL_KEYUP || event.type == SDL_WINDOWEVENT) this->current_scene->dirty = true;
+        
+        switch (event.type) {
+            // End game
+            case SDL_QUIT:
+            case SDL_WINDOWEVENT_CLOSE:
+                this->game_is_running = false;
+                break;
+                
+            case SDL_KEYDOWN:
+                switch (event.key.keysym.sym) {
+                    case SDLK_q:
+                        // Quit the game with a keystroke
+                        this->game_is_running = false;
+                        break;
+                        
+                    case SDLK_w:
+                        // Jump
+                        if (player->collided_bottom)
+                        {
+                            player->is_jumping = true;
+                            Mix_PlayChannel(-1, this->current_scene->state.jump_sfx, 0);
+                        }
+                        break;
+                    case SDLK_e:
+                        // Dash Attack
+                        player->is_dashing = true;
+                        Mix_PlayChannel(-1, ((rand() % 100) < 50) ? this->current_scene->state.dash_sfx_1 : this->current_scene->state.dash_sfx_2, 0);
+                        player->animation_indices = player->walking[player->DOWN];
+                        break;
+                    case SDLK_f:
+                        // Fullscreen at the desktop's resolution; only the final upscale gets bigger
+                        this->fullscreen = !this->fullscreen;
+                        SDL_SetWindowFullscreen(this->display_window, this->fullscreen ? SDL_WINDOW_FULLSCREEN_DESKTOP : 0);
+                        break;
+                        
+                    case SDLK_RETURN:
+                        switch_to_scene(this->level_a);
+                        player = this->current_scene->state.player;
+                    default:
+                        break;
+                }
+                
+            default:
+                break;
+        }
+    }
+    
+    const Uint8 *key_state = SDL_GetKeyboardState(NULL);
+
+    if (key_state[SDL_SCANCODE_A])
+    {
+        player->movement.x = -1.0f;
+        player->animation_indices = player->walking[player->LEFT];
+    }
+    else if (key_state[SDL_SCANCODE_D])
+    {
+        player->movement.x = 1.0f;
+        player->animation_indices = player->walking[player->RIGHT];
+    }
+    if (key_state[SDL_SCANCODE_SPACE])
+    {
+        player->is_shielding = true;
+        Mix_PlayChannel(-1, this->current_scene->state.shield_sfx, 0);
+        player->animation_indices = player->walking[player->UP];
+    }
+    
+    if (glm::length(player->movement) > 1.0f)
+    {
+        player->movement = glm::normalize(player->movement);
+    }
+}
+
+bool GameInstance::update()
+{
+    float ticks = (float)SDL_GetTicks() / MILLISECONDS_IN_SECOND;
+    float delta_time = ticks - this->previous_ticks;
+    this->previous_ticks = ticks;
+    
+    delta_time += this->accumulator;
+    
+    if (delta_time < FIXED_TIMESTEP)
+    {
+        this->accumulator = delta_time;
+        return false;
+    }
+    
+    while (delta_time >= FIXED_TIMESTEP) {
+        this->current_scene->update(FIXED_TIMESTEP);
+        
+        delta_time -= FIXED_TIMESTEP;
+    }
+    
+    this->accumulator = delta_time;
+    
+    
+    // Prevent the camera from showing anything outside of the "edge" of the level
+    this->view_matrix = glm::mat4(1.0f);
+    
+    if (this->current_scene->state.player->get_position().x > LEVEL1_LEFT_EDGE) {
+        this->view_matrix = glm::translate(this->view_matrix, glm::vec3(-this->current_scene->state.player->get_position().x, 3.75, 0));
+    } else {
+        this->view_matrix = glm::translate(this->view_matrix, glm::vec3(-5, 3.75, 0));
+    }
+    
+    return true;
+}
+
+void GameInstance::render()
+{
+    // Each instance draws into its own window's context
+    SDL_GL_MakeCurrent(this->display_window, this->context);
+    
+    // Before the scene's own drawing starts, since the cache has a framebuffer of its own
+    if (this->background_cache.is_created()) this->background_cache.update(this->current_scene->state.map, &this->program, this->view_matrix);
+    
+    this->program.SetViewMatrix(this->view_matrix);
+    
+    if (this->render_target.is_created()) this->render_target.begin();
+    else glViewport(VIEWPORT_X, VIEWPORT_Y, VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
+    
+    // present() and the background cache clear to colours of their own, so the sky goes back in every frame
+    glClearColor(BG_RED, BG_BLUE, BG_GREEN, BG_OPACITY);
+    glClear(GL_COLOR_BUFFER_BIT);
+    
+    this->current_scene->render(&this->program);
+    this->current_scene->dirty = false;
+    
+    if (this->render_target.is_created())
+    {
+        int drawable_width, drawable_height;
+        SDL_GL_GetDrawableSize(this->display_window, &drawable_width, &drawable_height);
+        this->render_target.present(drawable_width, drawable_height);
+    }
+
+    if (!this->current_scene->state.player->get_active_state())
+    {
+        this->lives -= 1;
+        if (this->lives != 0)
+            switch_to_scene(this->level_a);
+        else switch_to_scene(this->level_fail);
+    }
+    else if (this->current_scene->state.player->get_threat_count() == 0)
+    {
+        switch (this->current_scene->state.next_scene_id)
+        {
+        case 2:
+            switch_to_scene(this->level_b);
+            break;
+        case 3:
+            switch_to_scene(this->level_c);
+            break;
+        case 4:
+            switch_to_scene(this->level_win);
+        default:
+            break;
+        }
+    }
+    
+    SDL_GL_SwapWindow(this->display_window);
+}
+
+void GameInstance::run_frame()
+{
+    this->pacer->begin_frame();
+    
+    if (this->current_scene->idle && !this->current_scene->dirty)
+    {
+        // Nothing on screen can change until an event comes in, so sleep in the queue (the event stays
+        // there for process_input). Time spent here isn't simulated
+        SDL_WaitEventTimeout(NULL, IDLE_WAIT_MS);
+        this->previous_ticks = (float) SDL_GetTicks() / MILLISECONDS_IN_SECOND;
+        this->accumulator = 0.0f;
+    }
+    
+    this->process_input();
+    bool advanced = this->update();
+    
+    bool rendered = this->current_scene->idle ? this->current_scene->dirty : this->pacer->should_render(advanced);
+    if (rendered) this->render();
+    
+    this->pacer->end_frame(rendered);
+}
+
+void GameInstance::shutdown()
+{
+    delete this->pacer;
+    this->pacer = NULL;
+    
+    delete this->level_menu;
+    delete this->level_a;
+    delete this->level_b;
+    delete this->level_c;
+    delete this->level_win;
+    delete this->level_fail;
+    
+    // While the context is still there to delete it from
+    this->render_target.destroy();
+    this->background_cache.destroy();
+    
+    SDL_GL_DeleteContext(this->context);
+    SDL_DestroyWindow(this->display_window);
+}
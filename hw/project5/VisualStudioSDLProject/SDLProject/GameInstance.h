@@ -0,0 +1,76 @@
+#pragma once
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "glm/gtc/matrix_transform.hpp"
+#include "ShaderProgram.h"
+#include "FramePacer.h"
+#include "RenderTarget.h"
+#include "BackgroundCache.h"
+#include "Scene.h"
+#include "LevelA.h"
+#include "LevelB.h"
+#include "LevelC.h"
+#include "Level_W.h"
+#include "Level_M.h"
+#include "Level_F.h"
+
+/**
+ One running copy of the game: its window, shader, camera, clock, lives and scenes. The game state
+ lives here rather than in mutable globals, but input still comes from SDL's process-wide event
+ queue and keyboard state, and SDL video and event calls belong on the main thread, so run one
+ interactive instance per process. Headless simulation goes through BatchRunner instead.
+ */
+class GameInstance {
+private:
+    Scene *current_scene = NULL;
+    LevelA *level_a = NULL;
+    LevelB *level_b = NULL;
+    LevelC *level_c = NULL;
+    Level_W *level_win = NULL;
+    Level_F *level_fail = NULL;
+    Level_M *level_menu = NULL;
+    
+    SDL_Window *display_window = NULL;
+    SDL_GLContext context = NULL;
+    bool game_is_running = true;
+    int lives = 3;
+    
+    ShaderProgram program;
+    glm::mat4 view_matrix, projection_matrix;
+    
+    // The scene's fixed-size canvas, scaled up to whatever the window is. Left uncreated if the driver
+    // has no framebuffers, and then the scene draws straight to the window as before
+    RenderTarget render_target;
+    BackgroundCache background_cache; // the current scene's map, drawn once and panned over
+    bool fullscreen = false;
+    
+    float previous_ticks = 0.0f;
+    float accumulator = 0.0f;
+    FramePacer *pacer = NULL;
+    
+    void switch_to_scene(Scene *scene);
+    
+public:
+    GameInstance() {}
+    GameInstance(const GameInstance &) = delete;
+    GameInstance &operator=(const GameInstance &) = delete;
+    
+    void initialise();
+    void process_input();
+    bool update(); // false when not enough time has passed for a step
+    void render();
+    
+    // One paced pass of process_input, update and (if the pacer wants it) render
+    void run_frame();
+    void shutdown();
+    
+    bool const is_running() const { return this->game_is_running; }
+};
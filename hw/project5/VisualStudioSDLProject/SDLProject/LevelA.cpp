@@ -1,10 +1,11 @@
 #include "LevelA.h"
 #include "Utility.h"
+#include "StaticLevel.h"
 
 #define LEVEL_WIDTH 14
 #define LEVEL_HEIGHT 8
 
-unsigned int LEVEL_A_DATA[] =
+constexpr unsigned int LEVEL_A_DATA[] =
 {
     3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
     3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0,
@@ -16,6 +17,9 @@ unsigned int LEVEL_A_DATA[] =
     3, 1, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0
 };
 
+// Vertices, texture coordinates and collision bits, all worked out by the compiler
+constexpr StaticLevel<LEVEL_WIDTH, LEVEL_HEIGHT, 4, 1> LEVEL_A(LEVEL_A_DATA);
+
 LevelA::~LevelA()
 {
     delete [] this->state.enemies;
@@ -32,8 +36,8 @@ LevelA::~LevelA()
 
 void LevelA::initialise()
 {
-    GLuint map_texture_id = Utility::load_texture("assets/customtileset.png");
-    this->state.map = new Map(LEVEL_WIDTH, LEVEL_HEIGHT, LEVEL_A_DATA, map_texture_id, 1.0f, 4, 1);
+    GLuint map_texture_id = this->load_texture("assets/customtileset.png");
+    this->state.map = new Map(LEVEL_A, map_texture_id, 1.0f);
     this->state.next_scene_id = 2;
     
     // Code from main.cpp's initialise()
@@ -47,7 +51,7 @@ void LevelA::initialise()
     state.player->set_movement(glm::vec3(0.0f));
     state.player->speed = 2.5f;
     state.player->set_acceleration(glm::vec3(0.0f, -9.81f, 0.0f));
-    state.player->texture_id = Utility::load_texture("assets/geralt.png");
+    state.player->texture_id = this->load_texture("assets/geralt.png");
     
     // Walking
     state.player->walking[state.player->LEFT]  = new int[4] { 1, 5, 9,  13 };
@@ -71,7 +75,7 @@ void LevelA::initialise()
     
     /**
      Enemies' stuff */
-    GLuint enemy_texture_id = Utility::load_texture("assets/ghoul.png");
+    GLuint enemy_texture_id = this->load_texture("assets/ghoul.png");
     
     state.enemies = new Entity[this->ENEMY_COUNT];
     state.enemies[0].set_entity_type(ENEMY);
@@ -82,35 +86,36 @@ void LevelA::initialise()
     state.enemies[0].set_movement(glm::vec3(0.0f));
     state.enemies[0].speed = 1.0f;
     state.enemies[0].set_acceleration(glm::vec3(0.0f, -9.81f, 0.0f));
+
+    // Events
+    state.events.clear();
+    state.events.attach(state.player);
+    for (int i = 0; i < ENEMY_COUNT; i++) state.events.attach(&state.enemies[i]);
+    
+    // Animation
+    state.animations.clear();
+    state.animations.add(state.player);
+    for (int i = 0; i < ENEMY_COUNT; i++) state.animations.add(&state.enemies[i]);
     
     
     /**
      BGM and SFX
      */
-    Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 4096);
-
-    state.bgm = Mix_LoadMUS("assets/kmc.mp3");
-    Mix_PlayMusic(state.bgm, -1);
-    Mix_VolumeMusic(MIX_MAX_VOLUME / 15.0f);
-
-    state.jump_sfx = Mix_LoadWAV("assets/grunt.wav");
-    state.win_sfx = Mix_LoadWAV("assets/win.wav");
-    state.lose_sfx = Mix_LoadWAV("assets/lose.wav");
-    state.dash_sfx_1 = Mix_LoadWAV("assets/dash.wav");
-    state.dash_sfx_2 = Mix_LoadWAV("assets/dash2.wav");
-    state.shield_sfx = Mix_LoadWAV("assets/shield.wav");
+    this->load_audio();
 }
 
 void LevelA::update(float delta_time) 
 {
     this->state.player->update(delta_time, state.player, state.enemies, this->ENEMY_COUNT, this->state.map);
     for (int i = 0; i < ENEMY_COUNT; i++) this->state.enemies[i].update(delta_time, state.player, NULL, 0, this->state.map);
+    this->state.animations.advance(delta_time);
+    this->state.events.resolve();
     
 }
 
 void LevelA::render(ShaderProgram *program)
 {
-    this->state.map->render(program);
+    this->render_map(program);
     this->state.player->render(program);
 
     for (int i = 0; i < ENEMY_COUNT; i++)
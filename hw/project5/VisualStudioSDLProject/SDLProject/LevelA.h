@@ -1,5 +1,8 @@
+#pragma once
 #include "Scene.h"
 
+extern const unsigned int LEVEL_A_DATA[];
+
 class LevelA : public Scene {
 public:
     int ENEMY_COUNT = 1;
@@ -1,10 +1,11 @@
 #include "Level_F.h"
 #include "Utility.h"
+#include "StaticLevel.h"
 
 #define LEVEL_WIDTH 14
 #define LEVEL_HEIGHT 8
 
-unsigned int LEVEL_F_DATA[] =
+static constexpr unsigned int LEVEL_F_DATA[] =
 {
     3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0,
     3, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3, 0, 0, 0,
@@ -16,6 +17,9 @@ unsigned int LEVEL_F_DATA[] =
     3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 3, 0, 0, 0
 };
 
+// Vertices, texture coordinates and collision bits, all worked out by the compiler
+static constexpr StaticLevel<LEVEL_WIDTH, LEVEL_HEIGHT, 4, 1> LEVEL_F(LEVEL_F_DATA);
+
 Level_F::~Level_F()
 {
     delete    this->state.player;
@@ -31,16 +35,17 @@ Level_F::~Level_F()
 
 void Level_F::initialise()
 {
-    GLuint map_texture_id = Utility::load_texture("assets/customtileset.png");
-    this->state.map = new Map(LEVEL_WIDTH, LEVEL_HEIGHT, LEVEL_F_DATA, map_texture_id, 1.0f, 4, 1);
+    GLuint map_texture_id = this->load_texture("assets/customtileset.png");
+    this->state.map = new Map(LEVEL_F, map_texture_id, 1.0f);
     this->state.next_scene_id = 0;
+    this->idle = true;
     state.player = new Entity();
     state.player->set_entity_type(PLAYER);
     state.player->set_position(glm::vec3(5.0f, 0.0f, 0.0f));
     state.player->set_movement(glm::vec3(0.0f));
     state.player->speed = 2.5f;
     state.player->set_acceleration(glm::vec3(0.0f, -9.81f, 0.0f));
-    state.player->texture_id = Utility::load_texture("assets/geralt.png");
+    state.player->texture_id = this->load_texture("assets/geralt.png");
 
     // Walking
     state.player->walking[state.player->LEFT] = new int[4]{ 1, 5, 9,  13 };
@@ -61,7 +66,7 @@ void Level_F::initialise()
     state.player->jumping_power = 5.0f;
     state.player->dashing_speed = 100.0f;
     state.player->set_threat_count(ENEMY_COUNT);
-    GLuint enemy_texture_id = Utility::load_texture("assets/ghoul.png");
+    GLuint enemy_texture_id = this->load_texture("assets/ghoul.png");
 
     state.enemies = new Entity[this->ENEMY_COUNT];
     state.enemies[0].set_entity_type(ENEMY);
@@ -75,18 +80,7 @@ void Level_F::initialise()
     /**
      BGM and SFX
      */
-    Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 4096);
-
-    state.bgm = Mix_LoadMUS("assets/kmc.mp3");
-    Mix_PlayMusic(state.bgm, -1);
-    Mix_VolumeMusic(MIX_MAX_VOLUME / 15.0f);
-
-    state.jump_sfx = Mix_LoadWAV("assets/grunt.wav");
-    state.win_sfx = Mix_LoadWAV("assets/win.wav");
-    state.lose_sfx = Mix_LoadWAV("assets/lose.wav");
-    state.dash_sfx_1 = Mix_LoadWAV("assets/dash.wav");
-    state.dash_sfx_2 = Mix_LoadWAV("assets/dash2.wav");
-    state.shield_sfx = Mix_LoadWAV("assets/shield.wav");
+    this->load_audio();
 }
 
 void Level_F::update(float delta_time)
@@ -96,6 +90,6 @@ void Level_F::update(float delta_time)
 
 void Level_F::render(ShaderProgram* program)
 {
-    this->state.map->render(program);
+    this->render_map(program);
     Utility::draw_text(program, "YOU DIED", 1.0f, -0.5f, glm::vec3(3.2f, -3.0f, 0.0f));
 }
\ No newline at end of file
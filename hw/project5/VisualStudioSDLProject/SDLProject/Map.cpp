@@ -1,11 +1,21 @@
 #include "Map.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
 
-Map::Map(int width, int height, unsigned int *level_data, GLuint texture_id, float tile_size, int tile_count_x, int tile_count_y)
+// Shared by every Map and started by the first one big enough to need it
+static WorkStealingPool &get_build_pool()
+{
+    static WorkStealingPool pool;
+    return pool;
+}
+
+Map::Map(int width, int height, const unsigned int *level_data, GLuint texture_id, float tile_size, int tile_count_x, int tile_count_y)
 {
     this->width = width;
     this->height = height;
     
-    this->level_data = level_data;
+    this->level_storage.assign(level_data, level_data + width * height);
+    this->level_data = this->level_storage.data();
     this->texture_id = texture_id;
     
     this->tile_size = tile_size;
@@ -15,44 +25,139 @@ Map::Map(int width, int height, unsigned int *level_data, GLuint texture_id, flo
     this->build();
 }
 
-void Map::build()
+Map::Map(const StaticLevelData &level, GLuint texture_id, float tile_size)
+{
+    this->width = level.width;
+    this->height = level.height;
+    
+    this->level_data = level.tiles;
+    this->texture_id = texture_id;
+    
+    this->tile_size = tile_size;
+    this->tile_count_x = level.tile_count_x;
+    this->tile_count_y = level.tile_count_y;
+    
+    if (tile_size != 1.0f)
+    {
+        this->build();
+        return;
+    }
+    
+    this->vertices            = level.vertices;
+    this->texture_coordinates = level.texture_coordinates;
+    this->vertex_count        = level.vertex_count;
+    this->solid_bits          = level.solid_bits;
+    
+    this->set_bounds();
+}
+
+void Map::build(bool parallel)
 {
-    for(int y = 0; y < this->height; y++)
+    int tile_count = this->width * this->height;
+    
+    // Bands are whole words of the solid bitmap, so no two bands ever write to the same word
+    int band_count = 1;
+    if (parallel && tile_count >= MAP_PARALLEL_MIN_TILES) band_count = get_build_pool().get_thread_count() * MAP_BANDS_PER_THREAD;
+    
+    int band_size = ((tile_count + band_count - 1) / band_count + 31) / 32 * 32;
+    band_count = band_size > 0 ? (tile_count + band_size - 1) / band_size : 0;
+    
+    std::vector<int> band_offsets(band_count + 1, 0);
+    
+    // Pass one: how many tiles each band draws
+    for (int band = 0; band < band_count; band++)
     {
-        for(int x = 0; x < this->width; x++) {
-            int tile = this->level_data[y * this->width + x];
-            
-            if (tile == 0) continue;
-            
-            float u = (float) (tile % this->tile_count_x) / (float) this->tile_count_x;
-            float v = (float) (tile / this->tile_count_x) / (float) this->tile_count_y;
-            
-            float tile_width = 1.0f/ (float) this->tile_count_x;
-            float tile_height = 1.0f/ (float) this->tile_count_y;
-            
-            float x_offset = -(this->tile_size / 2); // From center of tile
-            float y_offset = (this->tile_size / 2); // From center of tile
-            
-            this->vertices.insert(vertices.end(), {
-                x_offset + (this->tile_size * x), y_offset + -this->tile_size * y,
-                x_offset + (this->tile_size * x), y_offset + (-this->tile_size * y) - this->tile_size,
-                x_offset + (this->tile_size * x) + this->tile_size, y_offset + (-this->tile_size * y) - this->tile_size,
-                x_offset + (this->tile_size * x), y_offset + -this->tile_size * y,
-                x_offset + (this->tile_size * x) + this->tile_size, y_offset + (-this->tile_size * y) - tile_size,
-                x_offset + (this->tile_size * x) + this->tile_size, y_offset + -this->tile_size * y
-            });
-            
-            this->texture_coordinates.insert(texture_coordinates.end(), {
-                u, v,
-                u, v + (tile_height),
-                u + tile_width, v + (tile_height),
-                u, v,
-                u + tile_width, v + (tile_height),
-                u + tile_width, v
-            });
-        }
+        int first_slot = band * band_size;
+        int last_slot  = std::min(first_slot + band_size, tile_count);
+        
+        if (band_count == 1) band_offsets[band + 1] = this->count_tiles(first_slot, last_slot);
+        else get_build_pool().submit([this, &band_offsets, band, first_slot, last_slot] {
+            band_offsets[band + 1] = this->count_tiles(first_slot, last_slot);
+        });
     }
+    if (band_count > 1) get_build_pool().wait();
+    
+    // Running total, so each band knows where its vertices start
+    for (int band = 0; band < band_count; band++) band_offsets[band + 1] += band_offsets[band];
+    this->vertex_count = band_offsets[band_count] * 6;
     
+    this->vertex_storage.resize(this->vertex_count * 2);
+    this->texture_coordinate_storage.resize(this->vertex_count * 2);
+    this->solid_storage.assign((tile_count + 31) / 32, 0);
+    
+    // Pass two: every band fills its own stretch of the buffers
+    for (int band = 0; band < band_count; band++)
+    {
+        int first_slot   = band * band_size;
+        int last_slot    = std::min(first_slot + band_size, tile_count);
+        int first_vertex = band_offsets[band] * 6;
+        
+        if (band_count == 1) this->fill_tiles(first_slot, last_slot, first_vertex);
+        else get_build_pool().submit([this, first_slot, last_slot, first_vertex] {
+            this->fill_tiles(first_slot, last_slot, first_vertex);
+        });
+    }
+    if (band_count > 1) get_build_pool().wait();
+    
+    this->vertices            = this->vertex_storage.data();
+    this->texture_coordinates = this->texture_coordinate_storage.data();
+    this->solid_bits          = this->solid_storage.data();
+    
+    this->set_bounds();
+}
+
+int const Map::count_tiles(int first_slot, int last_slot) const
+{
+    int count = 0;
+    for (int slot = first_slot; slot < last_slot; slot++)
+    {
+        if (this->level_data[slot] != 0) count++;
+    }
+    return count;
+}
+
+void Map::fill_tiles(int first_slot, int last_slot, int first_vertex)
+{
+    float *vertices            = this->vertex_storage.data() + first_vertex * 2;
+    float *texture_coordinates = this->texture_coordinate_storage.data() + first_vertex * 2;
+    
+    float tile_width  = 1.0f / (float) this->tile_count_x;
+    float tile_height = 1.0f / (float) this->tile_count_y;
+    
+    float x_offset = -(this->tile_size / 2); // From center of tile
+    float y_offset = (this->tile_size / 2);  // From center of tile
+    
+    for (int slot = first_slot; slot < last_slot; slot++)
+    {
+        int tile = this->level_data[slot];
+        
+        if (tile == 0) continue;
+        this->solid_storage[slot / 32] |= (uint32_t) 1 << (slot % 32);
+        
+        int x = slot % this->width;
+        int y = slot / this->width;
+        
+        float u = (float) (tile % this->tile_count_x) / (float) this->tile_count_x;
+        float v = (float) (tile / this->tile_count_x) / (float) this->tile_count_y;
+        
+        float left   = x_offset + (this->tile_size * x);
+        float right  = left + this->tile_size;
+        float top    = y_offset + -this->tile_size * y;
+        float bottom = top - this->tile_size;
+        
+        float corners[12] = { left, top, left, bottom, right, bottom, left, top, right, bottom, right, top };
+        float uvs[12] = { u, v, u, v + tile_height, u + tile_width, v + tile_height,
+                          u, v, u + tile_width, v + tile_height, u + tile_width, v };
+        
+        std::copy(corners, corners + 12, vertices);
+        std::copy(uvs, uvs + 12, texture_coordinates);
+        vertices += 12;
+        texture_coordinates += 12;
+    }
+}
+
+void Map::set_bounds()
+{
     this->left_bound   = 0 - (this->tile_size / 2);
     this->right_bound  = (this->tile_size * this->width) - (this->tile_size / 2);
     this->top_bound    = 0 + (this->tile_size / 2);
@@ -66,40 +171,14 @@ void Map::render(ShaderProgram *program)
     
     glUseProgram(program->programID);
     
-    glVertexAttribPointer(program->positionAttribute, 2, GL_FLOAT, false, 0, this->vertices.data());
+    glVertexAttribPointer(program->positionAttribute, 2, GL_FLOAT, false, 0, this->vertices);
     glEnableVertexAttribArray(program->positionAttribute);
-    glVertexAttribPointer(program->texCoordAttribute, 2, GL_FLOAT, false, 0, this->texture_coordinates.data());
+    glVertexAttribPointer(program->texCoordAttribute, 2, GL_FLOAT, false, 0, this->texture_coordinates);
     glEnableVertexAttribArray(program->texCoordAttribute);
     
     glBindTexture(GL_TEXTURE_2D, this->texture_id);
     
-    glDrawArrays(GL_TRIANGLES, 0, (int) this->vertices.size() / 2);
+    glDrawArrays(GL_TRIANGLES, 0, this->vertex_count);
     glDisableVertexAttribArray(program->positionAttribute);
     glDisableVertexAttribArray(program->texCoordAttribute);
 }
-
-bool Map::is_solid(glm::vec3 position, float *penetration_x, float *penetration_y)
-{
-    *penetration_x = 0;
-    *penetration_y = 0;
-    
-    if (position.x < this->left_bound || position.x > this->right_bound) return false;
-    if (position.y > this->top_bound || position.y < this->bottom_bound) return false;
-    
-    int tile_x = floor((position.x + (this->tile_size / 2)) / this->tile_size);
-    int tile_y = -(ceil(position.y - (this->tile_size / 2))) / this->tile_size; // Our array counts up as Y goes down.
-    
-    if (tile_x < 0 || tile_x >= this->width) return false;
-    if (tile_y < 0 || tile_y >= this->height) return false;
-    
-    int tile = level_data[tile_y * this->width + tile_x];
-    if (tile == 0) return false;
-    
-    float tile_center_x = (tile_x * this->tile_size);
-    float tile_center_y = -(tile_y * this->tile_size);
-    
-    *penetration_x = (this->tile_size / 2) - fabs(position.x - tile_center_x);
-    *penetration_y = (this->tile_size / 2) - fabs(position.y - tile_center_y);
-    
-    return true;
-}
@@ -4,6 +4,7 @@
 #include <GL/glew.h>
 #endif
 #define GL_GLEXT_PROTOTYPES 1
+#include <stdint.h>
 #include <vector>
 #include <math.h>
 #include <SDL.h>
@@ -12,48 +13,114 @@
 #include "glm/mat4x4.hpp"
 #include "glm/gtc/matrix_transform.hpp"
 #include "ShaderProgram.h"
+#include "Physics.h"
+
+#define MAP_PARALLEL_MIN_TILES 65536 // smaller maps build on the calling thread; a 14x8 level isn't worth waking anyone
+#define MAP_BANDS_PER_THREAD 4       // a few bands each, so a worker with a sparse band steals from one with a dense band
+
+// A level the compiler has already built (see StaticLevel.h), reduced to plain pointers
+struct StaticLevelData
+{
+    int width;
+    int height;
+    int tile_count_x;
+    int tile_count_y;
+    const unsigned int *tiles;
+    const float        *vertices;            // for a tile size of 1
+    const float        *texture_coordinates;
+    int                 vertex_count;
+    const uint32_t     *solid_bits;
+};
 
 class Map {
 private:
     int width;
     int height;
     
-    unsigned int *level_data;
+    // Each Map keeps its own copy, so the level arrays can stay read-only and be shared by any number of games.
+    // Built-in levels are read-only data already, and every Map made from one reads from it in place
+    std::vector<unsigned int> level_storage;
+    const unsigned int *level_data;
     GLuint texture_id;
     
     float tile_size;
     int tile_count_x;
     int tile_count_y;
     
-    std::vector<float> vertices;
-    std::vector<float> texture_coordinates;
+    std::vector<float> vertex_storage;
+    std::vector<float> texture_coordinate_storage;
+    std::vector<uint32_t> solid_storage;
+    
+    const float *vertices;
+    const float *texture_coordinates;
+    int vertex_count;
+    const uint32_t *solid_bits; // one bit per tile, set where it's solid
     
     float left_bound, right_bound, top_bound, bottom_bound;
     
+    void set_bounds();
+    int const count_tiles(int first_slot, int last_slot) const;
+    void fill_tiles(int first_slot, int last_slot, int first_vertex);
+    bool const is_solid_slot(int slot) const { return (this->solid_bits[slot / 32] >> (slot % 32)) & 1; }
+    
 public:
-    Map(int width, int height, unsigned int *level_data, GLuint texture_id, float tile_size, int
+    Map(int width, int height, const unsigned int *level_data, GLuint texture_id, float tile_size, int
     tile_count_x, int tile_count_y);
+    // Nothing left to build unless tile_size isn't 1
+    Map(const StaticLevelData &level, GLuint texture_id, float tile_size);
     
-    void build();
+    // Two passes over bands of tiles: count each band's tiles, add the counts up into offsets, then fill
+    // buffers sized once up front. Big maps run both passes across every core; parallel = false keeps
+    // them on the calling thread
+    void build(bool parallel = true);
     void render(ShaderProgram *program);
-    bool is_solid(glm::vec3 position, float *penetration_x, float *penetration_y);
+    // Templated on the vector/scalar pair so float and fixed-point physics share one implementation
+    template <typename Vector, typename Scalar>
+    bool is_solid(Vector position, Scalar *penetration_x, Scalar *penetration_y) const;
     
     // Getters
     int const get_width()  const  { return this->width;  }
     int const get_height() const  { return this->height; }
     
-    unsigned int* const get_level_data() const { return this->level_data; }
+    const unsigned int* get_level_data() const { return this->level_data; }
     GLuint        const get_texture_id() const { return this->texture_id; }
     
     float const get_tile_size() const { return this->tile_size; }
     int const get_tile_count_x() const { return this->tile_count_x; }
     int const get_tile_count_y() const { return this->tile_count_y; }
     
-    std::vector<float> const get_vertices()            const { return this->vertices;             }
-    std::vector<float> const get_texture_coordinates() const { return this-> texture_coordinates; }
+    const float* get_vertices()            const { return this->vertices;            }
+    const float* get_texture_coordinates() const { return this->texture_coordinates; }
+    int const    get_vertex_count()        const { return this->vertex_count;        }
     
     float const get_left_bound()   const { return this->left_bound;   }
     float const get_right_bound()  const { return this->right_bound;  }
     float const get_top_bound()    const { return this->top_bound;    }
     float const get_bottom_bound() const { return this->bottom_bound; }
 };
+
+template <typename Vector, typename Scalar>
+bool Map::is_solid(Vector position, Scalar *penetration_x, Scalar *penetration_y) const
+{
+    *penetration_x = 0;
+    *penetration_y = 0;
+    
+    if (position.x < this->left_bound || position.x > this->right_bound) return false;
+    if (position.y > this->top_bound || position.y < this->bottom_bound) return false;
+    
+    int tile_x = (int) floor((position.x + (this->tile_size / 2)) / this->tile_size);
+    int tile_y = (int) (-(ceil(position.y - (this->tile_size / 2))) / this->tile_size); // Our array counts up as Y goes down.
+    
+    if (tile_x < 0 || tile_x >= this->width) return false;
+    if (tile_y < 0 || tile_y >= this->height) return false;
+    
+    if (!this->is_solid_slot(tile_y * this->width + tile_x)) return false;
+    
+    Scalar tile_center_x = (tile_x * this->tile_size);
+    Scalar tile_center_y = -(tile_y * this->tile_size);
+    
+    *penetration_x = (this->tile_size / 2) - fabs(position.x - tile_center_x);
+    *penetration_y = (this->tile_size / 2) - fabs(position.y - tile_center_y);
+    
+    return true;
+}
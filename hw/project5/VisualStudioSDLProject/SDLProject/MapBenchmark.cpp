@@ -0,0 +1,124 @@
+#include "MapBenchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <string.h>
+
+#define BENCHMARK_TILES_PER_SIZE 4000000 // small maps are built over and over until about this many tiles are done
+
+/**
+ Rolling ground with the odd gap and floating ledge, so bands come out unevenly full the way real
+ levels do. Same every run.
+ */
+static std::vector<unsigned int> generate_level(int width, int height)
+{
+    std::vector<unsigned int> level(width * height, 0);
+    uint32_t seed = 2166136261u;
+
+    for (int x = 0; x < width; x++)
+    {
+        seed = (seed ^ (uint32_t) x) * 16777619u;
+        int ground = height / 2 + (int) ((height / 4) * sin(x * 0.05)) + (int) (seed % 3);
+        bool gap = seed % 17 == 0;
+
+        for (int y = 0; y < height; y++)
+        {
+            if (y >= ground && !gap) level[y * width + x] = y == ground ? 1 : 2;
+            else if (y % 7 == 3 && (x / 5 + y) % 4 == 0) level[y * width + x] = 3;
+        }
+    }
+
+    return level;
+}
+
+/**
+ Map::build as it was: one pass, growing the vectors a tile at a time.
+ */
+static void append_build(const Map &map, std::vector<float> &vertices, std::vector<float> &texture_coordinates)
+{
+    vertices.clear();
+    texture_coordinates.clear();
+
+    float tile_size = map.get_tile_size();
+    int tile_count_x = map.get_tile_count_x();
+    int tile_count_y = map.get_tile_count_y();
+
+    for (int y = 0; y < map.get_height(); y++)
+    {
+        for (int x = 0; x < map.get_width(); x++)
+        {
+            int tile = map.get_level_data()[y * map.get_width() + x];
+            if (tile == 0) continue;
+
+            float u = (float) (tile % tile_count_x) / (float) tile_count_x;
+            float v = (float) (tile / tile_count_x) / (float) tile_count_y;
+
+            float tile_width = 1.0f / (float) tile_count_x;
+            float tile_height = 1.0f / (float) tile_count_y;
+
+            float x_offset = -(tile_size / 2);
+            float y_offset = (tile_size / 2);
+
+            vertices.insert(vertices.end(), {
+                x_offset + (tile_size * x), y_offset + -tile_size * y,
+                x_offset + (tile_size * x), y_offset + (-tile_size * y) - tile_size,
+                x_offset + (tile_size * x) + tile_size, y_offset + (-tile_size * y) - tile_size,
+                x_offset + (tile_size * x), y_offset + -tile_size * y,
+                x_offset + (tile_size * x) + tile_size, y_offset + (-tile_size * y) - tile_size,
+                x_offset + (tile_size * x) + tile_size, y_offset + -tile_size * y
+            });
+
+            texture_coordinates.insert(texture_coordinates.end(), {
+                u, v,
+                u, v + (tile_height),
+                u + tile_width, v + (tile_height),
+                u, v,
+                u + tile_width, v + (tile_height),
+                u + tile_width, v
+            });
+        }
+    }
+}
+
+template <typename Build>
+static double time_builds(int repeats, Build build)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) build();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count() * 1000.0 / repeats;
+}
+
+void benchmark_map_build(int max_size)
+{
+    int sizes[][2] = { { 14, 8 }, { 64, 64 }, { 256, 256 }, { 1024, 1024 }, { 2048, 2048 }, { 4096, 4096 } };
+
+    std::cout << "size\ttiles drawn\tappend ms\t1 thread ms\tall cores ms\tsame\n";
+
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+    {
+        int width = sizes[i][0], height = sizes[i][1];
+        if (width > max_size || height > max_size) break;
+
+        std::vector<unsigned int> level = generate_level(width, height);
+        Map map = Map(width, height, level.data(), 0, 1.0f, 4, 1);
+
+        int repeats = std::max(1, BENCHMARK_TILES_PER_SIZE / (width * height));
+        std::vector<float> vertices, texture_coordinates;
+
+        // Bit for bit, so a band landing in the wrong place or out of order shows up
+        auto matches_append = [&] {
+            return (int) vertices.size() == map.get_vertex_count() * 2 &&
+                   memcmp(vertices.data(), map.get_vertices(), vertices.size() * sizeof(float)) == 0 &&
+                   memcmp(texture_coordinates.data(), map.get_texture_coordinates(), vertices.size() * sizeof(float)) == 0;
+        };
+
+        double append_ms   = time_builds(repeats, [&] { append_build(map, vertices, texture_coordinates); });
+        double serial_ms   = time_builds(repeats, [&] { map.build(false); });
+        bool same = matches_append();
+        double parallel_ms = time_builds(repeats, [&] { map.build(true); });
+        same = same && matches_append();
+
+        std::cout << width << 'x' << height << "\t" << map.get_vertex_count() / 6 << "\t\t"
+                  << append_ms << "\t" << serial_ms << "\t" << parallel_ms << "\t" << (same ? "yes" : "NO") << '\n';
+    }
+}
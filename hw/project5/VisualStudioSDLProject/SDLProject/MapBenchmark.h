@@ -0,0 +1,9 @@
+#pragma once
+#include "Map.h"
+
+/**
+ Builds generated maps from the 14x8 levels up to max_size x max_size tiles three ways: the old loop
+ that appended each tile's vertices as it went, Map::build on the calling thread and Map::build across
+ every core. Prints the time per build for each and checks all three came out the same.
+ */
+void benchmark_map_build(int max_size);
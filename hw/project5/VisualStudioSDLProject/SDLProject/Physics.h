@@ -0,0 +1,52 @@
+#pragma once
+#include "glm/vec3.hpp"
+#include "Fixed.h"
+
+/**
+ The number type physics runs on. Define PHYSICS_FIXED_POINT (here or in the project's preprocessor
+ definitions) to integrate every body in Q16.16 so a run is bit-for-bit the same on every build and
+ machine, e.g. for lockstep replays. Left undefined, physics stays on float exactly as before.
+ */
+// #define PHYSICS_FIXED_POINT
+
+/**
+ glm::vec3 for the fixed-point scalar. Only what Entity and Map::is_solid need.
+ */
+template <typename Scalar>
+struct PhysicsVector
+{
+    Scalar x, y, z;
+
+    PhysicsVector() : x(0), y(0), z(0) {}
+    PhysicsVector(Scalar x, Scalar y, Scalar z) : x(x), y(y), z(z) {}
+    explicit PhysicsVector(glm::vec3 vector) : x(vector.x), y(vector.y), z(vector.z) {}
+
+    PhysicsVector &operator+=(PhysicsVector other) { x += other.x; y += other.y; z += other.z; return *this; }
+    PhysicsVector &operator-=(PhysicsVector other) { x -= other.x; y -= other.y; z -= other.z; return *this; }
+
+    friend PhysicsVector operator+(PhysicsVector a, PhysicsVector b) { return a += b; }
+    friend PhysicsVector operator-(PhysicsVector a, PhysicsVector b) { return a -= b; }
+    friend PhysicsVector operator*(PhysicsVector a, Scalar scale) { return PhysicsVector(a.x * scale, a.y * scale, a.z * scale); }
+};
+
+#ifdef PHYSICS_FIXED_POINT
+typedef Fixed16                      physics_scalar;
+typedef PhysicsVector<Fixed16>       physics_vec3;
+#else
+typedef float                        physics_scalar;
+typedef glm::vec3                    physics_vec3;
+#endif
+
+// Getters hand glm::vec3 to rendering and gameplay code whichever scalar is in use
+inline glm::vec3 to_vec3(glm::vec3 vector) { return vector; }
+
+template <int FRACTION_BITS>
+inline glm::vec3 to_vec3(PhysicsVector<Fixed<FRACTION_BITS> > vector)
+{
+    return glm::vec3(vector.x.to_float(), vector.y.to_float(), vector.z.to_float());
+}
+
+inline float to_float(float value) { return value; }
+
+template <int FRACTION_BITS>
+inline float to_float(Fixed<FRACTION_BITS> value) { return value.to_float(); }
@@ -0,0 +1,104 @@
+#include "PhysicsBenchmark.h"
+#include <chrono>
+#include <iostream>
+#include <string.h>
+
+#define BENCHMARK_TIMESTEP 0.0166666f
+
+template <typename Vector, typename Scalar>
+struct Body
+{
+    Vector position;
+    Vector velocity;
+};
+
+inline uint32_t body_bits(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+template <int FRACTION_BITS>
+inline uint32_t body_bits(Fixed<FRACTION_BITS> value) { return (uint32_t) value.get_raw(); }
+
+/**
+ A trimmed copy of Entity::update's movement: no AI or entity collisions, just what the scalar type
+ affects.
+ */
+template <typename Vector, typename Scalar>
+uint32_t simulate(Map *map, int body_count, int step_count, double *seconds)
+{
+    std::vector<Body<Vector, Scalar> > bodies(body_count);
+    for (int i = 0; i < body_count; i++)
+    {
+        bodies[i].position = Vector(Scalar(1 + i % 12), Scalar(0), Scalar(0));
+        bodies[i].velocity = Vector(Scalar(0), Scalar(0), Scalar(0));
+    }
+
+    Scalar step      = BENCHMARK_TIMESTEP;
+    Scalar gravity   = -9.81f;
+    Scalar speed     = 2.5f;
+    Scalar jump      = 5.0f;
+    Scalar half_size = 0.4f;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (int s = 0; s < step_count; s++)
+    {
+        for (int i = 0; i < body_count; i++)
+        {
+            Body<Vector, Scalar> &body = bodies[i];
+            Scalar penetration_x = 0;
+            Scalar penetration_y = 0;
+
+            // Run back and forth, jumping whenever there's ground underfoot
+            body.velocity.x = ((s / 120 + i) % 2 == 0) ? speed : -speed;
+            body.velocity.y += gravity * step;
+
+            body.position.y += body.velocity.y * step;
+            if (map->is_solid(Vector(body.position.x, body.position.y - half_size, Scalar(0)), &penetration_x, &penetration_y) && body.velocity.y < 0)
+            {
+                body.position.y += penetration_y;
+                body.velocity.y = jump;
+            }
+
+            body.position.x += body.velocity.x * step;
+            if (map->is_solid(Vector(body.position.x + half_size, body.position.y, Scalar(0)), &penetration_x, &penetration_y) && body.velocity.x > 0)
+            {
+                body.position.x -= penetration_x;
+            }
+            if (map->is_solid(Vector(body.position.x - half_size, body.position.y, Scalar(0)), &penetration_x, &penetration_y) && body.velocity.x < 0)
+            {
+                body.position.x += penetration_x;
+            }
+
+            // Anything that falls off the level starts again at the top
+            if (body.position.y < -10.0f) body.position.y = 0;
+        }
+    }
+
+    *seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    uint32_t checksum = 2166136261u;
+    for (int i = 0; i < body_count; i++)
+    {
+        checksum = (checksum ^ body_bits(bodies[i].position.x)) * 16777619u;
+        checksum = (checksum ^ body_bits(bodies[i].position.y)) * 16777619u;
+    }
+
+    return checksum;
+}
+
+void benchmark_physics(Map *map, int body_count, int step_count)
+{
+    double float_seconds = 0.0;
+    double fixed_seconds = 0.0;
+
+    uint32_t float_checksum = simulate<glm::vec3, float>(map, body_count, step_count, &float_seconds);
+    uint32_t fixed_checksum = simulate<PhysicsVector<Fixed16>, Fixed16>(map, body_count, step_count, &fixed_seconds);
+
+    std::cout << body_count << " bodies x " << step_count << " steps\n";
+    std::cout << "float:  " << float_seconds * 1000.0 << " ms, checksum " << std::hex << float_checksum << std::dec << '\n';
+    std::cout << "Q16.16: " << fixed_seconds * 1000.0 << " ms, checksum " << std::hex << fixed_checksum << std::dec << '\n';
+}
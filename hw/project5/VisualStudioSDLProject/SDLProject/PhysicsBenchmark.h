@@ -0,0 +1,10 @@
+#pragma once
+#include "Map.h"
+#include "Physics.h"
+
+/**
+ Runs the same platformer integration (gravity, run, jump, tile collision) on float and on Q16.16 over
+ a map and prints how long each took along with a checksum of the final bodies. Two fixed-point runs
+ printing the same checksum on different machines is the reproducibility check.
+ */
+void benchmark_physics(Map *map, int body_count, int step_count);
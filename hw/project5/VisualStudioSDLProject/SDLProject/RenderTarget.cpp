@@ -0,0 +1,113 @@
+#include "RenderTarget.h"
+#include <algorithm>
+
+RenderTarget::~RenderTarget()
+{
+    this->destroy();
+}
+
+bool RenderTarget::create(int width, int height, const char *vertex_shader_path, const char *fragment_shader_path)
+{
+    this->destroy();
+    
+    this->width = width;
+    this->height = height;
+    
+    glGenTextures(1, &this->texture_id);
+    glBindTexture(GL_TEXTURE_2D, this->texture_id);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL);
+    
+    // Nearest, so whole-number scaling copies each texel into a block instead of smearing it
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    
+    glGenFramebuffers(1, &this->framebuffer_id);
+    glBindFramebuffer(GL_FRAMEBUFFER, this->framebuffer_id);
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, this->texture_id, 0);
+    
+    GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    
+    if (status != GL_FRAMEBUFFER_COMPLETE)
+    {
+        this->destroy();
+        return false;
+    }
+    
+    // The quad is already in clip space, so every matrix stays the identity
+    this->present_program.Load(vertex_shader_path, fragment_shader_path);
+    this->present_program.SetProjectionMatrix(glm::mat4(1.0f));
+    this->present_program.SetViewMatrix(glm::mat4(1.0f));
+    this->present_program.SetModelMatrix(glm::mat4(1.0f));
+    
+    this->created = true;
+    return true;
+}
+
+void RenderTarget::destroy()
+{
+    if (this->framebuffer_id != 0) glDeleteFramebuffers(1, &this->framebuffer_id);
+    if (this->texture_id != 0)     glDeleteTextures(1, &this->texture_id);
+    if (this->created)             this->present_program.Cleanup();
+    
+    this->framebuffer_id = 0;
+    this->texture_id = 0;
+    this->created = false;
+}
+
+void RenderTarget::begin()
+{
+    // Still bound from the last present(), and a texture can't be read while it's being drawn into
+    glBindTexture(GL_TEXTURE_2D, 0);
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, this->framebuffer_id);
+    glViewport(0, 0, this->width, this->height);
+}
+
+void RenderTarget::present(int drawable_width, int drawable_height)
+{
+    // Largest whole-number scale that fits. A window smaller than the target can't have one, so it
+    // gets the image shrunk to fit instead
+    int scale = std::min(drawable_width / this->width, drawable_height / this->height);
+    int viewport_width  = this->width * scale;
+    int viewport_height = this->height * scale;
+    
+    if (scale < 1)
+    {
+        float fit = std::min((float) drawable_width / this->width, (float) drawable_height / this->height);
+        viewport_width  = (int) (this->width * fit);
+        viewport_height = (int) (this->height * fit);
+    }
+    
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(0, 0, drawable_width, drawable_height);
+    glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    
+    glViewport((drawable_width - viewport_width) / 2, (drawable_height - viewport_height) / 2,
+               viewport_width, viewport_height);
+    
+    float vertices[] = { -1.0f, -1.0f, 1.0f, -1.0f, 1.0f, 1.0f, -1.0f, -1.0f, 1.0f, 1.0f, -1.0f, 1.0f };
+    float texture_coordinates[] = { 0.0f, 0.0f, 1.0f, 0.0f, 1.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 0.0f, 1.0f };
+    
+    // A straight copy; blending would mix the scene's alpha into the window
+    GLboolean blending = glIsEnabled(GL_BLEND);
+    glDisable(GL_BLEND);
+    
+    glUseProgram(this->present_program.programID);
+    glBindTexture(GL_TEXTURE_2D, this->texture_id);
+    
+    glVertexAttribPointer(this->present_program.positionAttribute, 2, GL_FLOAT, false, 0, vertices);
+    glEnableVertexAttribArray(this->present_program.positionAttribute);
+    glVertexAttribPointer(this->present_program.texCoordAttribute, 2, GL_FLOAT, false, 0, texture_coordinates);
+    glEnableVertexAttribArray(this->present_program.texCoordAttribute);
+    
+    glDrawArrays(GL_TRIANGLES, 0, 6);
+    
+    glDisableVertexAttribArray(this->present_program.positionAttribute);
+    glDisableVertexAttribArray(this->present_program.texCoordAttribute);
+    
+    if (blending) glEnable(GL_BLEND);
+}
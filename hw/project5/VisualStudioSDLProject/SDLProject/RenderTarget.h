@@ -0,0 +1,52 @@
+#pragma once
+#define GL_SILENCE_DEPRECATION
+
+#ifdef _WINDOWS
+#include <GL/glew.h>
+#endif
+
+#define GL_GLEXT_PROTOTYPES 1
+#include <SDL.h>
+#include <SDL_opengl.h>
+#include "glm/mat4x4.hpp"
+#include "ShaderProgram.h"
+
+/**
+ An offscreen framebuffer at a fixed resolution. The scene draws into it between begin() and present(),
+ and present() puts it on the window in one quad, scaled by the largest whole number that fits and
+ centred with black bars, so every texel lands on a square block of pixels. Drawing the scene costs
+ the same however big the window gets; only the final quad grows.
+ */
+class RenderTarget {
+private:
+    GLuint framebuffer_id = 0;
+    GLuint texture_id = 0;
+    int width = 0;
+    int height = 0;
+    
+    ShaderProgram present_program;
+    bool created = false;
+    
+public:
+    RenderTarget() {}
+    RenderTarget(const RenderTarget &) = delete;
+    RenderTarget &operator=(const RenderTarget &) = delete;
+    ~RenderTarget();
+    
+    // Shaders are the plain textured pair. False (and nothing created) if the driver won't give a
+    // complete framebuffer, in which case the caller keeps drawing straight to the window
+    bool create(int width, int height, const char *vertex_shader_path, const char *fragment_shader_path);
+    void destroy();
+    
+    // Binds the framebuffer and sets the viewport to cover it
+    void begin();
+    
+    // Back to the window's framebuffer, then draws the image at the window's drawable size. Leaves
+    // blending as it found it and the present shader in use
+    void present(int drawable_width, int drawable_height);
+    
+    bool const is_created() const { return this->created; }
+    int const get_width()  const  { return this->width;  }
+    int const get_height() const  { return this->height; }
+    GLuint const get_texture_id() const { return this->texture_id; }
+};
@@ -1 +1,35 @@
 #include "Scene.h"
+
+GLuint Scene::load_texture(const char *filepath)
+{
+    // Headless scenes never touch GL; a texture id of 0 is simply never drawn
+    if (this->headless) return 0;
+    
+    return Utility::load_texture(filepath);
+}
+
+void Scene::render_map(ShaderProgram *program)
+{
+    // Straight from the vertex arrays when there's no cache or it's holding some other map
+    if (this->background_cache != NULL && this->background_cache->render(this->state.map, program)) return;
+    
+    this->state.map->render(program);
+}
+
+void Scene::load_audio()
+{
+    if (this->headless) return;
+    
+    Mix_OpenAudio(44100, MIX_DEFAULT_FORMAT, 2, 4096);
+
+    state.bgm = Mix_LoadMUS("assets/kmc.mp3");
+    Mix_PlayMusic(state.bgm, -1);
+    Mix_VolumeMusic(MIX_MAX_VOLUME / 15.0f);
+
+    state.jump_sfx = Mix_LoadWAV("assets/grunt.wav");
+    state.win_sfx = Mix_LoadWAV("assets/win.wav");
+    state.lose_sfx = Mix_LoadWAV("assets/lose.wav");
+    state.dash_sfx_1 = Mix_LoadWAV("assets/dash.wav");
+    state.dash_sfx_2 = Mix_LoadWAV("assets/dash2.wav");
+    state.shield_sfx = Mix_LoadWAV("assets/shield.wav");
+}
@@ -15,20 +15,25 @@
 #include "Utility.h"
 #include "Entity.h"
 #include "Map.h"
+#include "BackgroundCache.h"
+#include "AnimationSystem.h"
 
 struct GameState
 {
-    Map *map;
-    Entity *player;
-    Entity *enemies;
-    
-    Mix_Music* bgm;
-    Mix_Chunk* jump_sfx;
-    Mix_Chunk* win_sfx;
-    Mix_Chunk* lose_sfx;
-    Mix_Chunk* dash_sfx_1;
-    Mix_Chunk* dash_sfx_2;
-    Mix_Chunk* shield_sfx;
+    Map *map = NULL;
+    Entity *player = NULL;
+    Entity *enemies = NULL;
+    EventBus events;
+    AnimationSystem animations;
+    
+    // Left NULL when the scene is headless
+    Mix_Music* bgm = NULL;
+    Mix_Chunk* jump_sfx = NULL;
+    Mix_Chunk* win_sfx = NULL;
+    Mix_Chunk* lose_sfx = NULL;
+    Mix_Chunk* dash_sfx_1 = NULL;
+    Mix_Chunk* dash_sfx_2 = NULL;
+    Mix_Chunk* shield_sfx = NULL;
     
     int next_scene_id;
 };
@@ -37,8 +42,25 @@ class Scene {
 public:
     int number_of_enemies = 1;
     
+    // Set before initialise() to simulate without a window or audio device (batch runs)
+    bool headless = false;
+    
+    // Idle scenes (menu, win and fail screens) have nothing moving on their own, so the loop only
+    // redraws them when dirty and otherwise sleeps until input arrives
+    bool idle = false;
+    bool dirty = true;
+    
+    // Set by the GameInstance when it keeps the map cached in a texture; render_map draws from it
+    BackgroundCache *background_cache = NULL;
+    
     GameState state;
     
+    GLuint load_texture(const char *filepath);
+    void load_audio();
+    void render_map(ShaderProgram *program);
+    
+    virtual ~Scene() {}
+    
     virtual void initialise() = 0;
     virtual void update(float delta_time) = 0;
     virtual void render(ShaderProgram *program) = 0;
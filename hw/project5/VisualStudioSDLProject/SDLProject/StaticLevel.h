@@ -0,0 +1,64 @@
+#pragma once
+#include <stdint.h>
+#include "Map.h"
+
+/**
+ A built-in level worked out entirely by the compiler: the vertices and texture coordinates Map::build
+ would make (for a tile size of 1) and the collision bits end up as read-only data, and a Map built
+ from it draws and collides straight out of them. Declared constexpr next to the level array it
+ comes from; an array that isn't exactly WIDTH * HEIGHT tiles doesn't compile.
+ */
+template <int WIDTH, int HEIGHT, int TILE_COUNT_X, int TILE_COUNT_Y>
+struct StaticLevel
+{
+    unsigned int tiles[WIDTH * HEIGHT];
+    float        vertices[WIDTH * HEIGHT * 12];
+    float        texture_coordinates[WIDTH * HEIGHT * 12];
+    int          vertex_count;
+    uint32_t     solid_bits[(WIDTH * HEIGHT + 31) / 32];
+
+    constexpr StaticLevel(const unsigned int (&level_data)[WIDTH * HEIGHT])
+        : tiles(), vertices(), texture_coordinates(), vertex_count(0), solid_bits()
+    {
+        // Same tiles, same order and same numbers as Map::build
+        for (int y = 0; y < HEIGHT; y++)
+        {
+            for (int x = 0; x < WIDTH; x++)
+            {
+                int slot = y * WIDTH + x;
+                unsigned int tile = level_data[slot];
+                this->tiles[slot] = tile;
+
+                if (tile == 0) continue;
+                this->solid_bits[slot / 32] |= (uint32_t) 1 << (slot % 32);
+
+                float u = (float) (tile % TILE_COUNT_X) / (float) TILE_COUNT_X;
+                float v = (float) (tile / TILE_COUNT_X) / (float) TILE_COUNT_Y;
+                float tile_width  = 1.0f / (float) TILE_COUNT_X;
+                float tile_height = 1.0f / (float) TILE_COUNT_Y;
+
+                float left = -0.5f + x, right = left + 1.0f;
+                float top  =  0.5f - y, bottom = top - 1.0f;
+
+                float corners[12] = { left, top, left, bottom, right, bottom, left, top, right, bottom, right, top };
+                float uvs[12] = { u, v, u, v + tile_height, u + tile_width, v + tile_height,
+                                  u, v, u + tile_width, v + tile_height, u + tile_width, v };
+
+                for (int i = 0; i < 12; i++)
+                {
+                    this->vertices[this->vertex_count * 2 + i]            = corners[i];
+                    this->texture_coordinates[this->vertex_count * 2 + i] = uvs[i];
+                }
+                this->vertex_count += 6;
+            }
+        }
+    }
+
+    // What Map takes; the template parameters become plain fields
+    operator StaticLevelData() const
+    {
+        StaticLevelData data = { WIDTH, HEIGHT, TILE_COUNT_X, TILE_COUNT_Y, this->tiles, this->vertices,
+                                 this->texture_coordinates, this->vertex_count, this->solid_bits };
+        return data;
+    }
+};
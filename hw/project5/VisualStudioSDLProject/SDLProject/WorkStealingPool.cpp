@@ -0,0 +1,150 @@
+#include "WorkStealingPool.h"
+#include <assert.h>
+
+// The pool the current thread works for and which of its queues is the thread's own. Only meaningful
+// to that pool: a worker of one pool submitting to or waiting on another is just an outside thread there
+static thread_local const WorkStealingPool *worker_owner = NULL;
+static thread_local int worker_index = -1;
+
+// Pools with a job running on the current thread, innermost first, linked through run()'s stack frames
+struct RunningJob
+{
+    const WorkStealingPool *pool;
+    RunningJob *outer;
+};
+static thread_local RunningJob *running_jobs = NULL;
+
+WorkStealingPool::WorkStealingPool(int thread_count) : queued(0), pending(0), next_queue(0)
+{
+    if (thread_count <= 0) thread_count = (int) std::thread::hardware_concurrency();
+    if (thread_count <= 0) thread_count = 1;
+
+    for (int i = 0; i < thread_count; i++) this->queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+    for (int i = 0; i < thread_count; i++) this->threads.push_back(std::thread(&WorkStealingPool::run_worker, this, i));
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        std::lock_guard<std::mutex> guard(this->sleep_lock);
+        this->stopping = true;
+    }
+    this->wake.notify_all();
+
+    for (size_t i = 0; i < this->threads.size(); i++) this->threads[i].join();
+}
+
+void WorkStealingPool::submit(Job job)
+{
+    // Jobs spawned by a worker stay on its own queue; everything else is dealt out round-robin
+    int own_index = this->get_worker_index();
+    int index = own_index >= 0 ? own_index : (int) (this->next_queue++ % this->queues.size());
+
+    this->pending++;
+    {
+        std::lock_guard<std::mutex> guard(this->queues[index]->lock);
+        this->queues[index]->jobs.push_back(job);
+    }
+
+    {
+        std::lock_guard<std::mutex> guard(this->sleep_lock);
+        this->queued++;
+    }
+    this->wake.notify_one();
+}
+
+bool WorkStealingPool::take(int index, Job &job)
+{
+    int count = (int) this->queues.size();
+
+    // Own queue first, newest job (its data is most likely still in cache)
+    if (index >= 0)
+    {
+        WorkerQueue &own = *this->queues[index];
+        std::lock_guard<std::mutex> guard(own.lock);
+        if (!own.jobs.empty())
+        {
+            job = own.jobs.back();
+            own.jobs.pop_back();
+            this->queued--;
+            return true;
+        }
+    }
+
+    // Then steal the oldest job from the others, starting with our neighbour
+    for (int i = 1; i <= count; i++)
+    {
+        WorkerQueue &victim = *this->queues[(index + i + count) % count];
+        std::lock_guard<std::mutex> guard(victim.lock);
+        if (!victim.jobs.empty())
+        {
+            job = victim.jobs.front();
+            victim.jobs.pop_front();
+            this->queued--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void WorkStealingPool::run(Job &job)
+{
+    RunningJob running = { this, running_jobs };
+    running_jobs = &running;
+    job();
+    running_jobs = running.outer;
+
+    if (--this->pending == 0)
+    {
+        std::lock_guard<std::mutex> guard(this->sleep_lock);
+        this->finished.notify_all();
+    }
+}
+
+void WorkStealingPool::run_worker(int index)
+{
+    worker_owner = this;
+    worker_index = index;
+
+    while (true)
+    {
+        Job job;
+        if (this->take(index, job))
+        {
+            this->run(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(this->sleep_lock);
+        this->wake.wait(guard, [this] { return this->stopping || this->queued > 0; });
+        if (this->stopping) return;
+    }
+}
+
+void WorkStealingPool::wait()
+{
+    for (RunningJob *running = running_jobs; running != NULL; running = running->outer)
+    {
+        assert(running->pool != this && "WorkStealingPool::wait() called from inside one of its own jobs");
+    }
+
+    // The waiting thread lends a hand instead of just blocking
+    while (this->pending > 0)
+    {
+        Job job;
+        if (this->take(this->get_worker_index(), job))
+        {
+            this->run(job);
+            continue;
+        }
+
+        std::unique_lock<std::mutex> guard(this->sleep_lock);
+        this->finished.wait(guard, [this] { return this->pending == 0 || this->queued > 0; });
+    }
+}
+
+int const WorkStealingPool::get_worker_index() const
+{
+    return worker_owner == this ? worker_index : -1;
+}
@@ -1,9 +1,7 @@
 #define GL_SILENCE_DEPRECATION
 #define GL_GLEXT_PROTOTYPES 1
-#define FIXED_TIMESTEP 0.0166666f
 #define LEVEL1_WIDTH 14
 #define LEVEL1_HEIGHT 8
-#define LEVEL1_LEFT_EDGE 5.0f
 
 #ifdef _WINDOWS
 #include <GL/glew.h>
@@ -18,272 +16,71 @@
 #include "cmath"
 #include <ctime>
 #include <vector>
+#include <cstring>
+#include <iostream>
 #include "Entity.h"
 #include "Map.h"
 #include "Utility.h"
 #include "Scene.h"
 #include "LevelA.h"
-#include "LevelB.h"
-#include "LevelC.h"
-#include "Level_W.h"
-#include "Level_M.h"
-#include "Level_F.h"
+#include "GameInstance.h"
+#include "PhysicsBenchmark.h"
+#include "MapBenchmark.h"
+#include "BatchRunner.h"
 
 
 
 /**
- CONSTANTS
- */
-const int WINDOW_WIDTH  = 640,
-          WINDOW_HEIGHT = 480;
-
-const float BG_RED     = 0.1922f,
-            BG_BLUE    = 0.549f,
-            BG_GREEN   = 0.9059f,
-            BG_OPACITY = 1.0f;
-
-const int VIEWPORT_X = 0,
-          VIEWPORT_Y = 0,
-          VIEWPORT_WIDTH  = WINDOW_WIDTH,
-          VIEWPORT_HEIGHT = WINDOW_HEIGHT;
-
-const char V_SHADER_PATH[] = "shaders/vertex_textured.glsl",
-           F_SHADER_PATH[] = "shaders/fragment_textured.glsl";
-
-const float MILLISECONDS_IN_SECOND = 1000.0;
-
-/**
- VARIABLES
+ DRIVER GAME LOOP
  */
-Scene *current_scene;
-LevelA *level_a;
-LevelB* level_b;
-LevelC* level_c;
-Level_W* level_win;
-Level_F* level_fail;
-Level_M* level_menu;
-
-SDL_Window* display_window;
-bool game_is_running = true;
-int lives = 3;
-
-ShaderProgram program;
-glm::mat4 view_matrix, projection_matrix;
-
-float previous_ticks = 0.0f;
-float accumulator = 0.0f;
-
-void switch_to_scene(Scene *scene)
-{
-    current_scene = scene;
-    current_scene->initialise();
-}
-
-void initialise()
-{
-    SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO);
-    display_window = SDL_CreateWindow("Hello, Scenes!",
-                                      SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
-                                      WINDOW_WIDTH, WINDOW_HEIGHT,
-                                      SDL_WINDOW_OPENGL);
-    
-    SDL_GLContext context = SDL_GL_CreateContext(display_window);
-    SDL_GL_MakeCurrent(display_window, context);
-    
-#ifdef _WINDOWS
-    glewInit();
-#endif
-    
-    glViewport(VIEWPORT_X, VIEWPORT_Y, VIEWPORT_WIDTH, VIEWPORT_HEIGHT);
-    
-    program.Load(V_SHADER_PATH, F_SHADER_PATH);
-    
-    view_matrix = glm::mat4(1.0f);
-    projection_matrix = glm::ortho(-5.0f, 5.0f, -3.75f, 3.75f, -1.0f, 1.0f);
-    
-    program.SetProjectionMatrix(projection_matrix);
-    program.SetViewMatrix(view_matrix);
-    
-    glUseProgram(program.programID);
-    
-    glClearColor(BG_RED, BG_BLUE, BG_GREEN, BG_OPACITY);
-    
-    level_menu = new Level_M();
-    level_a = new LevelA();
-    level_b = new LevelB();
-    level_c = new LevelC();
-    level_win = new Level_W();
-    level_fail = new Level_F();
-    switch_to_scene(level_menu);
-    
-    // enable blending
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-}
-
-void process_input()
+int main(int argc, char* argv[])
 {
-    // VERY IMPORTANT: If nothing is pressed, we don't want to go anywhere
-    current_scene->state.player->set_movement(glm::vec3(0.0f));
-    
-    SDL_Event event;
-    while (SDL_PollEvent(&event))
-    {
-        switch (event.type) {
-            // End game
-            case SDL_QUIT:
-            case SDL_WINDOWEVENT_CLOSE:
-                game_is_running = false;
-                break;
-                
-            case SDL_KEYDOWN:
-                switch (event.key.keysym.sym) {
-                    case SDLK_q:
-                        // Quit the game with a keystroke
-                        game_is_running = false;
-                        break;
-                        
-                    case SDLK_w:
-                        // Jump
-                        if (current_scene->state.player->collided_bottom)
-                        {
-                            current_scene->state.player->is_jumping = true;
-                            Mix_PlayChannel(-1, current_scene->state.jump_sfx, 0);
-                        }
-                        break;
-                    case SDLK_e:
-                        // Dash Attack
-                        current_scene->state.player->is_dashing = true;
-                        Mix_PlayChannel(-1, ((rand() % 100) < 50) ? current_scene->state.dash_sfx_1 : current_scene->state.dash_sfx_2, 0);
-                        current_scene->state.player->animation_indices = current_scene->state.player->walking[current_scene->state.player->DOWN];
-                        break;
-                    case SDLK_RETURN:
-                        switch_to_scene(level_a);
-                    default:
-                        break;
-                }
-                
-            default:
-                break;
-        }
-    }
-    
-    const Uint8 *key_state = SDL_GetKeyboardState(NULL);
-
-    if (key_state[SDL_SCANCODE_A])
-    {
-        current_scene->state.player->movement.x = -1.0f;
-        current_scene->state.player->animation_indices = current_scene->state.player->walking[current_scene->state.player->LEFT];
-    }
-    else if (key_state[SDL_SCANCODE_D])
+    // Headless: "SDLProject --benchmark-physics" times float against fixed-point physics on level A
+    if (argc > 1 && strcmp(argv[1], "--benchmark-physics") == 0)
     {
-        current_scene->state.player->movement.x = 1.0f;
-        current_scene->state.player->animation_indices = current_scene->state.player->walking[current_scene->state.player->RIGHT];
+        Map map = Map(LEVEL1_WIDTH, LEVEL1_HEIGHT, LEVEL_A_DATA, 0, 1.0f, 4, 1);
+        benchmark_physics(&map, 1000, 600);
+        return 0;
     }
-    if (key_state[SDL_SCANCODE_SPACE])
-    {
-        current_scene->state.player->is_shielding = true;
-        Mix_PlayChannel(-1, current_scene->state.shield_sfx, 0);
-        current_scene->state.player->animation_indices = current_scene->state.player->walking[current_scene->state.player->UP];
-    }
-    
-    if (glm::length(current_scene->state.player->movement) > 1.0f)
-    {
-        current_scene->state.player->movement = glm::normalize(current_scene->state.player->movement);
-    }
-}
-
-void update()
-{
-    float ticks = (float)SDL_GetTicks() / MILLISECONDS_IN_SECOND;
-    float delta_time = ticks - previous_ticks;
-    previous_ticks = ticks;
     
-    delta_time += accumulator;
-    
-    if (delta_time < FIXED_TIMESTEP)
+    // Headless: "SDLProject --benchmark-map [largest side]" times Map::build from 14x8 up to 4096x4096
+    if (argc > 1 && strcmp(argv[1], "--benchmark-map") == 0)
     {
-        accumulator = delta_time;
-        return;
-    }
-    
-    while (delta_time >= FIXED_TIMESTEP) {
-        current_scene->update(FIXED_TIMESTEP);
-        
-        delta_time -= FIXED_TIMESTEP;
-    }
-    
-    accumulator = delta_time;
-    
-    
-    // Prevent the camera from showing anything outside of the "edge" of the level
-    view_matrix = glm::mat4(1.0f);
-    
-    if (current_scene->state.player->get_position().x > LEVEL1_LEFT_EDGE) {
-        view_matrix = glm::translate(view_matrix, glm::vec3(-current_scene->state.player->get_position().x, 3.75, 0));
-    } else {
-        view_matrix = glm::translate(view_matrix, glm::vec3(-5, 3.75, 0));
+        benchmark_map_build(argc > 2 ? atoi(argv[2]) : 4096);
+        return 0;
     }
-}
-
-void render()
-{
-    program.SetViewMatrix(view_matrix);
     
-    glClear(GL_COLOR_BUFFER_BIT);
-    
-    current_scene->render(&program);
-
-    if (!current_scene->state.player->get_active_state())
+    // Headless: "SDLProject --batch <level 1-3> <runs>" plays the level with random input on every core
+    if (argc > 3 && strcmp(argv[1], "--batch") == 0)
     {
-        lives -= 1;
-        if (lives != 0)
-            switch_to_scene(level_a);
-        else switch_to_scene(level_fail);
-    }
-    else if (current_scene->state.player->get_threat_count() == 0)
-    {
-        switch (current_scene->state.next_scene_id)
+        std::vector<SimulationConfig> configs(atoi(argv[3]));
+        for (size_t i = 0; i < configs.size(); i++)
         {
-        case 2:
-            switch_to_scene(level_b);
-            break;
-        case 3:
-            switch_to_scene(level_c);
-            break;
-        case 4:
-            switch_to_scene(level_win);
-        default:
-            break;
+            configs[i].level = atoi(argv[2]);
+            configs[i].seed  = (unsigned int) i;
         }
+        
+        BatchRunner runner;
+        BatchReport report = BatchRunner::summarise(runner.run(configs));
+        
+        std::cout << report.runs << " runs on " << runner.get_thread_count() << " threads\n";
+        std::cout << "completed: " << report.completed << ", mean time " << report.mean_completion_time
+                  << "s, best " << report.best_completion_time << "s\n";
+        std::cout << "mean deaths: " << report.mean_deaths << '\n';
+        std::cout << "mean threat_count per second:";
+        for (size_t i = 0; i < report.mean_threat_counts.size(); i++) std::cout << ' ' << report.mean_threat_counts[i];
+        std::cout << '\n';
+        return 0;
     }
     
-    SDL_GL_SwapWindow(display_window);
-}
-
-void shutdown()
-{    
-    SDL_Quit();
+    SDL_Init(SDL_INIT_VIDEO | SDL_INIT_AUDIO);
     
-    delete level_a;
-    delete level_b;
-    delete level_c;
-}
-
-/**
- DRIVER GAME LOOP
- */
-int main(int argc, char* argv[])
-{
-    initialise();
+    GameInstance game;
+    game.initialise();
     
-    while (game_is_running)
-    {
-        process_input();
-        update();
-        render();
-    }
+    while (game.is_running()) game.run_frame();
     
-    shutdown();
+    game.shutdown();
+    SDL_Quit();
     return 0;
 }